@@ -0,0 +1,119 @@
+#include "arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_BLOCK_CAPACITY_INIT 0x10000
+#define ARENA_BLOCK_CAPACITY_MAX 0x1000000
+#define ARENA_BLOCK_CAPACITY_INC(capacity) (capacity * 2)
+#define ARENA_SIZE_ALIGN(size) (((size) + sizeof(union arena_align) - 1) / sizeof(union arena_align) * sizeof(union arena_align))
+
+/**
+ * Push new block to arena, large enough to fit allocation of given size.
+ */
+static struct arena_block* arena_block_push(struct arena* arena, const size_t size)
+{
+	// Grow blocks with arena to keep the number of blocks small
+	size_t capacity = ARENA_BLOCK_CAPACITY_INIT;
+	if (arena->block)
+		capacity = (arena->block->capacity < ARENA_BLOCK_CAPACITY_MAX) ? ARENA_BLOCK_CAPACITY_INC(arena->block->capacity) : arena->block->capacity;
+
+	if (size > capacity)
+		capacity = size;
+
+	if (capacity > SIZE_MAX - sizeof(struct arena_block))
+		return NULL;
+
+	// Blocks are zeroed once when allocated, and memory is zeroed again when reset, so allocations are always zeroed
+	struct arena_block* block = calloc(1, sizeof(struct arena_block) + capacity);
+	if (!block)
+		return NULL;
+
+	block->prev = arena->block;
+	block->capacity = capacity;
+	arena->block = block;
+	return block;
+}
+
+void* arena_alloc(struct arena* arena, const size_t size)
+{
+	if (!arena || size > SIZE_MAX - sizeof(union arena_align))
+		return NULL;
+
+	size_t size_align = ARENA_SIZE_ALIGN(size);
+	struct arena_block* block = arena->block;
+	if ((!block || size_align > block->capacity - block->len) && !(block = arena_block_push(arena, size_align)))
+		return NULL;
+
+	block->last = block->len;
+	block->len += size_align;
+	return (uint8_t*)block->vals + block->last;
+}
+
+void* arena_realloc(struct arena* arena, void* vals, const size_t size, const size_t size_new)
+{
+	if (!arena || size_new > SIZE_MAX - sizeof(union arena_align))
+		return NULL;
+
+	if (!vals)
+		return arena_alloc(arena, size_new);
+
+	if (size_new <= size)
+		return vals;
+
+	// Grow last allocation in-place if it fits within the block
+	struct arena_block* block = arena->block;
+	size_t size_align = ARENA_SIZE_ALIGN(size_new);
+	if (block && vals == (uint8_t*)block->vals + block->last && size_align <= block->capacity - block->last) {
+		block->len = block->last + size_align;
+		return vals;
+	}
+
+	void* vals_new = arena_alloc(arena, size_new);
+	if (!vals_new)
+		return NULL;
+
+	return memcpy(vals_new, vals, size);
+}
+
+struct arena_mark arena_mark_get(const struct arena* arena)
+{
+	if (!arena || !arena->block)
+		return (struct arena_mark){ 0 };
+
+	return (struct arena_mark){ .block = arena->block, .len = arena->block->len, .last = arena->block->last };
+}
+
+void arena_reset(struct arena* arena, const struct arena_mark mark)
+{
+	if (!arena)
+		return;
+
+	// Free blocks pushed since position was marked
+	while (arena->block && arena->block != mark.block) {
+		struct arena_block* prev = arena->block->prev;
+		free(arena->block);
+		arena->block = prev;
+	}
+
+	if (!arena->block)
+		return;
+
+	// Zero memory allocated from block since position was marked, to be allocated again
+	memset((uint8_t*)arena->block->vals + mark.len, 0, arena->block->len - mark.len);
+	arena->block->len = mark.len;
+	arena->block->last = mark.last;
+}
+
+void arena_empty(struct arena* arena)
+{
+	if (!arena)
+		return;
+
+	while (arena->block) {
+		struct arena_block* prev = arena->block->prev;
+		free(arena->block);
+		arena->block = prev;
+	}
+}
@@ -0,0 +1,91 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/**
+ * Value with the strictest alignment of any allocation returned by arena.
+ */
+union arena_align {
+	long double ld;
+	long long ll;
+	void* p;
+	void (*f)(void);
+};
+
+/**
+ * Block of memory owned by arena.
+ */
+struct arena_block {
+	struct arena_block* prev;
+	size_t capacity; // Number of bytes available in block
+	size_t len; // Number of bytes allocated from block
+	size_t last; // Offset of last allocation from block, which can be resized in-place
+	union arena_align vals[];
+};
+
+/**
+ * Bump allocator owning many small allocations, all freed at once.
+ * Memory allocated from arena is zeroed and cannot be freed individually.
+ */
+struct arena {
+	struct arena_block* block; // Block currently allocated from, NULL if unallocated
+};
+
+/**
+ * Position within arena, which arena can be reset to.
+ */
+struct arena_mark {
+	struct arena_block* block; // Block allocated from when marked, NULL if arena was unallocated
+	size_t len;
+	size_t last;
+};
+
+/**
+ * Allocate zeroed memory from arena.
+ *
+ * @param arena Arena to allocate memory from.
+ * @param size Number of bytes to allocate.
+ * @returns Pointer to allocated memory. NULL if error.
+ */
+void* arena_alloc(struct arena* arena, const size_t size);
+
+/**
+ * Resize memory allocated from arena.
+ * Memory is resized in-place if it was the last allocation from arena, otherwise it is copied to a new allocation.
+ * Any newly available memory is zeroed.
+ *
+ * @param arena Arena memory was allocated from.
+ * @param vals Pointer to memory to resize. NULL to allocate new memory.
+ * @param size Number of bytes currently allocated.
+ * @param size_new Number of bytes to resize to.
+ * @returns Pointer to resized memory. NULL if error, in which case memory given is not changed.
+ */
+void* arena_realloc(struct arena* arena, void* vals, const size_t size, const size_t size_new);
+
+/**
+ * Get current position within arena.
+ *
+ * @param arena Arena to get position of.
+ * @returns Position within arena.
+ */
+struct arena_mark arena_mark_get(const struct arena* arena);
+
+/**
+ * Free all memory allocated from arena since position was marked, so it can be allocated again.
+ * Memory allocated before position was marked is kept, and memory allocated since must no longer be used.
+ *
+ * @param arena Arena to reset.
+ * @param mark Position within arena to reset to.
+ */
+void arena_reset(struct arena* arena, const struct arena_mark mark);
+
+/**
+ * Free all memory allocated from arena.
+ * Arena will be in unallocated state once memory is freed.
+ *
+ * @param arena Arena to free memory of.
+ */
+void arena_empty(struct arena* arena);
+
+#endif
@@ -3,10 +3,19 @@
 #include "assemble_basic.h"
 #include "assemble_full.h"
 
-size_t assemble_file(struct error* err, struct dynarr* instructions, const struct parsed_file file)
+void assemble_link_empty(struct assemble_link* link)
+{
+	if (!link)
+		return;
+
+	dynarr_empty(&link->relocs);
+	dynarr_empty(&link->exports);
+}
+
+size_t assemble_file(struct error* err, struct dynarr* instructions, const struct parsed_file file, struct assemble_link* link, const struct runner* runner)
 {
 	if (file.defs_macros.len == 0 && file.base.refs_macros.len == 0)
-		return assemble_file_basic(err, instructions, file.base);
+		return assemble_file_basic(err, instructions, file.base, file.syms, link);
 
-	return assemble_file_full(err, instructions, file);
+	return assemble_file_full(err, instructions, file, link, runner);
 }
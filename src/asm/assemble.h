@@ -3,6 +3,75 @@
 
 #include "err.h"
 #include "parsed.h"
+#include "runner.h"
+
+/**
+ * Type of relocation of assembled file.
+ */
+enum assemble_reloc_type {
+	RELOC_BASE_E, // Address within file, offset by the address the file is linked at
+	RELOC_SYMBOL_E // Data reference not defined within file, resolved once linked
+};
+
+/**
+ * Relocation of assembled file, patching an instruction once linked.
+ */
+struct assemble_reloc {
+	enum assemble_reloc_type type;
+	size_t offset; // Index of instruction to patch
+	symbol_t key; // Interned key of data reference if type is RELOC_SYMBOL_E
+};
+
+DYNARR_DEFINE(struct assemble_reloc, assemble_reloc)
+
+/**
+ * Linkage of assembled file, to link with other assembled files.
+ */
+struct assemble_link {
+	struct dynarr relocs; // Dynamic array of assemble_reloc, in order of offset
+	struct dynarr exports; // Dynamic array of parsed_def_data, root/file data definitions with labels offset by referenced macros
+};
+
+/**
+ * Macro-less file assembled as it is parsed.
+ * Data references not yet defined when parsed are patched once the whole file is parsed.
+ */
+struct assemble_stream {
+	struct dynarr* instructions; // Dynamic array to push NGC instructions
+	struct dynarr fixups; // Dynamic array of assemble_fixup, data references not yet defined when parsed, in order of line
+	size_t overflow_line_num; // Number of line of first instruction exceeding the instruction limit, 0 if none
+};
+
+/**
+ * Free values within linkage of assembled file.
+ */
+void assemble_link_empty(struct assemble_link* link);
+
+/**
+ * Assemble line of root/file scope of macro-less file as it is parsed.
+ *
+ * @param err Struct to store error.
+ * @param stream Macro-less file being assembled.
+ * @param file Parsed file, storing data definitions parsed so far.
+ * @param line Parsed line.
+ * @returns Whether line was assembled successfully.
+ */
+bool assemble_stream_line(struct error* err, struct assemble_stream* stream, const struct parsed_file* file, const struct parsed_line line);
+
+/**
+ * Complete assembly of macro-less file once the whole file is parsed, patching data references defined after they were parsed.
+ *
+ * @param err Struct to store error.
+ * @param stream Macro-less file being assembled.
+ * @param file Parsed file.
+ * @returns 0 if successfully assembled. >0 line number if error.
+ */
+size_t assemble_stream_end(struct error* err, struct assemble_stream* stream, const struct parsed_file file);
+
+/**
+ * Free values within macro-less file assembled as it is parsed.
+ */
+void assemble_stream_empty(struct assemble_stream* stream);
 
 /**
  * Assemble parsed file to NGC instructions.
@@ -10,8 +79,10 @@
  * @param error Struct to store error.
  * @param instructions Dynamic array to push NGC instructions.
  * @param file Parsed file.
+ * @param link Struct to store linkage of file, leaving data references not defined within file to be resolved once linked. NULL to assemble ROM.
+ * @param runner Runner of assembly jobs. NULL to assemble on the calling thread.
  * @returns 0 if successfully assembled. >0 line number if error.
  */
-size_t assemble_file(struct error* err, struct dynarr* instructions, const struct parsed_file file);
+size_t assemble_file(struct error* err, struct dynarr* instructions, const struct parsed_file file, struct assemble_link* link, const struct runner* runner);
 
 #endif
@@ -7,6 +7,17 @@
 #include <stdbool.h>
 #include <string.h>
 
+/**
+ * Data reference not yet defined when parsed, patched once the whole file is parsed.
+ */
+struct assemble_fixup {
+	size_t offset; // Index of instruction to patch
+	size_t line_num; // Number of line in file
+	symbol_t key; // Interned key of data reference
+};
+
+DYNARR_DEFINE(struct assemble_fixup, assemble_fixup)
+
 /**
  * Push NGC instruction.
  *
@@ -17,7 +28,7 @@
  */
 static bool inst_push(struct error* err, struct dynarr* instructions, const ngc_word_t inst)
 {
-	if (!dynarr_push(instructions, &inst, sizeof(inst))) {
+	if (!dynarr_word_push(instructions, inst)) {
 		error_init(err, ERRVAL_FAILURE, "Failed to push instruction");
 		return false;
 	}
@@ -25,71 +36,204 @@ static bool inst_push(struct error* err, struct dynarr* instructions, const ngc_
 	return true;
 }
 
-size_t assemble_file_basic(struct error* err, struct dynarr* instructions, const struct parsed_base file)
+/**
+ * Push relocation of next NGC instruction.
+ *
+ * @param err Struct to store error.
+ * @param link Linkage of file to push relocation to.
+ * @param type Type of relocation.
+ * @param offset Index of NGC instruction to patch.
+ * @param key Interned key of data reference if type is RELOC_SYMBOL_E.
+ * @returns Whether relocation was pushed successfully.
+ */
+static bool reloc_push(struct error* err, struct assemble_link* link, const enum assemble_reloc_type type, const size_t offset, const symbol_t key)
+{
+	struct assemble_reloc reloc = { .type = type, .offset = offset, .key = key };
+	if (!dynarr_assemble_reloc_push(&link->relocs, reloc)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push relocation");
+		return false;
+	}
+
+	return true;
+}
+
+size_t assemble_file_basic(struct error* err, struct dynarr* instructions, const struct parsed_base file, const struct symbols syms, struct assemble_link* link)
 {
 	if (!instructions) {
 		error_init(err, ERRVAL_FAILURE, "Instructions array is null");
 		return 1;
 	}
 
-	for (size_t lines_ind = 0; lines_ind < file.lines.len; lines_ind++) {
-		struct parsed_line* line = dynarr_get(file.lines, lines_ind);
-		if (!line)
-			continue;
+	// Export all data definitions, labels of a macro-less file are already addresses within file
+	if (link && file.defs_data.len > 0 && !dynarr_set(&link->exports, 0, file.defs_data.vals, file.defs_data.len, sizeof(struct parsed_def_data))) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push exported data definitions");
+		return 1;
+	}
 
-		switch (line->type) {
+	struct parsed_lines_iter iter = { 0 };
+	for (struct parsed_line line; parsed_lines_next(&file.lines, &iter, &line);) {
+		switch (line.type) {
 			case LINE_INST_E:
 				// Push instruction
-				if (!inst_push(err, instructions, (ngc_word_t)line->val))
-					return line->line_num;
+				if (!inst_push(err, instructions, (ngc_word_t)line.val))
+					return line.line_num;
 
 				break;
 
 			case LINE_REF_DATA_E:
 				;
 				// Get referenced data key at given index
-				char* data_key = dynarr_get(file.refs_data, line->val);
+				symbol_t* data_key = dynarr_symbol_get(&file.refs_data, line.val);
 				if (!data_key) {
-					error_init(err, ERRVAL_FAILURE, "Data reference index out of range: %zu", line->val);
-					return line->line_num;
+					error_init(err, ERRVAL_FAILURE, "Data reference index out of range: %zu", line.val);
+					return line.line_num;
 				}
 
 				// Get data definition using referenced data key
-				struct parsed_def_data* def_data = parsed_def_data_get(file.defs_data, data_key);
+				struct parsed_def_data* def_data = parsed_def_data_get(file.defs_data, file.defs_data_map, *data_key);
 				if (!def_data) {
 					// Try parse key as number if no data definition found using key
-					long parsed_number = parse_number(data_key, strlen(data_key));
+					const char* data_key_str = symbols_key(syms, *data_key);
+					long parsed_number = parse_number(data_key_str, strlen(data_key_str));
 					if (parsed_number >= 0) {
 						if (!inst_push(err, instructions, (ngc_word_t)parsed_number))
-							return line->line_num;
+							return line.line_num;
+
+						break;
+					}
+
+					// Data reference resolved once linked
+					if (link) {
+						if (!reloc_push(err, link, RELOC_SYMBOL_E, instructions->len, *data_key) || !inst_push(err, instructions, 0))
+							return line.line_num;
 
 						break;
 					}
 
-					error_init(err, ERRVAL_SYNTAX, "Data reference not defined: '%s'", data_key);
-					return line->line_num;
+					error_init(err, ERRVAL_SYNTAX, "Data reference not defined: '%s'", data_key_str);
+					return line.line_num;
 				}
 
+				// Labels are offset by the address the file is linked at
+				if (link && def_data->type == DATA_LABEL_E && !reloc_push(err, link, RELOC_BASE_E, instructions->len, *data_key))
+					return line.line_num;
+
 				// Push data instruction
 				if (!inst_push(err, instructions, (ngc_word_t)def_data->val))
-					return line->line_num;
+					return line.line_num;
 
 				break;
 
 			case LINE_REF_MACRO_E:
 				error_init(err, ERRVAL_FAILURE, "Macro reference found when none expected");
-				return line->line_num;
+				return line.line_num;
 
 			default:
-				error_init(err, ERRVAL_FAILURE, "Unknown line type: %d", line->type);
-				return line->line_num;
+				error_init(err, ERRVAL_FAILURE, "Unknown line type: %d", line.type);
+				return line.line_num;
 		}
 
 		if (instructions->len > NGC_UWORD_MAX) {
 			error_init(err, ERRVAL_FILE, "File contains too many instructions (max %zu)", NGC_UWORD_MAX);
-			return line->line_num;
+			return line.line_num;
 		}
 	}
 
 	return 0;
 }
+
+bool assemble_stream_line(struct error* err, struct assemble_stream* stream, const struct parsed_file* file, const struct parsed_line line)
+{
+	// Instructions beyond the instruction limit are not kept, the limit is reported once any error on an earlier line is
+	if (stream->overflow_line_num > 0)
+		return true;
+
+	ngc_word_t inst = 0;
+	switch (line.type) {
+		case LINE_INST_E:
+			inst = (ngc_word_t)line.val;
+			break;
+
+		case LINE_REF_DATA_E:
+			;
+			// Get referenced data key at given index
+			symbol_t* data_key = dynarr_symbol_get(&file->base.refs_data, line.val);
+			if (!data_key) {
+				error_init(err, ERRVAL_FAILURE, "Data reference index out of range: %zu", line.val);
+				return false;
+			}
+
+			// Data definitions parsed so far keep their value once the whole file is parsed
+			struct parsed_def_data* def_data = parsed_def_data_get(file->base.defs_data, file->base.defs_data_map, *data_key);
+			if (def_data) {
+				inst = (ngc_word_t)def_data->val;
+				break;
+			}
+
+			// Data defined after reference, or not defined
+			struct assemble_fixup fixup = { .offset = stream->instructions->len, .line_num = line.line_num, .key = *data_key };
+			if (!dynarr_assemble_fixup_push(&stream->fixups, fixup)) {
+				error_init(err, ERRVAL_FAILURE, "Failed to push data reference fixup");
+				return false;
+			}
+
+			break;
+
+		case LINE_REF_MACRO_E:
+			error_init(err, ERRVAL_FAILURE, "Macro reference found when none expected");
+			return false;
+
+		default:
+			error_init(err, ERRVAL_FAILURE, "Unknown line type: %d", line.type);
+			return false;
+	}
+
+	if (!inst_push(err, stream->instructions, inst))
+		return false;
+
+	if (stream->instructions->len > NGC_UWORD_MAX)
+		stream->overflow_line_num = line.line_num;
+
+	return true;
+}
+
+size_t assemble_stream_end(struct error* err, struct assemble_stream* stream, const struct parsed_file file)
+{
+	// Fixups are in order of line, so the first error is reported the same as assembling the stored lines of the file
+	for (size_t fixups_ind = 0; fixups_ind < stream->fixups.len; fixups_ind++) {
+		struct assemble_fixup* fixup = dynarr_assemble_fixup_get(&stream->fixups, fixups_ind);
+		ngc_word_t* inst = dynarr_word_get(stream->instructions, fixup->offset);
+
+		struct parsed_def_data* def_data = parsed_def_data_get(file.base.defs_data, file.base.defs_data_map, fixup->key);
+		if (def_data) {
+			*inst = (ngc_word_t)def_data->val;
+			continue;
+		}
+
+		// Try parse key as number if no data definition found using key
+		const char* data_key_str = symbols_key(file.syms, fixup->key);
+		long parsed_number = parse_number(data_key_str, strlen(data_key_str));
+		if (parsed_number >= 0) {
+			*inst = (ngc_word_t)parsed_number;
+			continue;
+		}
+
+		error_init(err, ERRVAL_SYNTAX, "Data reference not defined: '%s'", data_key_str);
+		return fixup->line_num;
+	}
+
+	if (stream->overflow_line_num > 0) {
+		error_init(err, ERRVAL_FILE, "File contains too many instructions (max %zu)", NGC_UWORD_MAX);
+		return stream->overflow_line_num;
+	}
+
+	return 0;
+}
+
+void assemble_stream_empty(struct assemble_stream* stream)
+{
+	if (!stream)
+		return;
+
+	dynarr_empty(&stream->fixups);
+}
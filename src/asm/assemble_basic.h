@@ -1,6 +1,7 @@
 #ifndef ASSEMBLE_BASIC_H
 #define ASSEMBLE_BASIC_H
 
+#include "assemble.h"
 #include "err.h"
 #include "parsed.h"
 
@@ -10,8 +11,10 @@
  * @param error Struct to store error.
  * @param instructions Dynamic array to push NGC instructions.
  * @param file Parsed file.
+ * @param syms Symbol pool keys of parsed file were interned within.
+ * @param link Struct to store linkage of file. NULL to assemble ROM.
  * @returns 0 if successfully assembled. >0 line number if error.
  */
-size_t assemble_file_basic(struct error* err, struct dynarr* instructions, const struct parsed_base file);
+size_t assemble_file_basic(struct error* err, struct dynarr* instructions, const struct parsed_base file, const struct symbols syms, struct assemble_link* link);
 
 #endif
@@ -5,328 +5,486 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define MACRO_DEPTH_MAX 0x200
+#define ASSEMBLE_JOB_LEN 0x400 // Minimum number of instructions of each job when split into multiple jobs
 
 /**
- * Expanded parsed assembly line.
- * Same struct as parsed_line, but redefined due to indexes referring to different dynamic arrays.
+ * State of macro template.
  */
-struct expanded_line {
-	enum parsed_line_type type;
-	size_t line_num;
-	size_t val; // Parsed instruction if type is LINE_INST_E, index of expanded_base.refs_data if type is LINE_REF_DATA_E, index of expanded_base.macros if type is LINE_REF_MACRO_E.
+enum template_state {
+	TEMPLATE_NONE_E, // Not compiled yet
+	TEMPLATE_COMPILING_E, // Being compiled - macro is referenced by itself if referenced again
+	TEMPLATE_COMPILED_E
 };
 
 /**
- * Expanded parsed macro parameter.
+ * Type of value resolved within macro template.
  */
-struct expanded_macro_param {
-	char key[PARSED_KEY_CHARS];
-	enum parsed_ref_macro_param_type type;
-	size_t val; // Parsed value if type is PARAM_CONST_E, index of expanded_base.parent->refs_data if type is PARAM_REF_DATA_E
+enum template_value_type {
+	VALUE_CONST_E, // Constant value
+	VALUE_LABEL_E, // Label defined within template
+	VALUE_PARAM_E, // Macro parameter of template
+	VALUE_REF_ROOT_E, // Data reference resolved within root/file scope
+	VALUE_CONFLICT_E, // Data reference defined within both template and root/file scopes
+	VALUE_ADDR_E // Absolute address of label, only resolved from arguments of macro being expanded
 };
 
 /**
- * Expanded parsed assembly.
+ * Value resolved within macro template.
+ * Values which are not constant are resolved when the template is expanded.
  */
-struct expanded_base {
-	struct expanded_base* parent;
-	size_t line_num;
-	size_t inst_len;
-	struct dynarr lines; // Dynamic array of expanded_line
-	struct dynarr macros; // Dynamic array of expanded_base
-	struct dynarr params; // Dynamic array of expanded_macro_param
-	struct dynarr refs_data; // Dynamic array of char[PARSED_KEY_CHARS]
-	struct dynarr defs_data; // Dynamic array of parsed_def_data
+struct template_value {
+	enum template_value_type type;
+	size_t line_num; // Number of line in file to report errors on
+	symbol_t key; // Interned key of data reference if type is VALUE_REF_ROOT_E or VALUE_CONFLICT_E
+	size_t val; // Constant if type is VALUE_CONST_E, index of instruction within expanded template if type is VALUE_LABEL_E, index of macro parameter if type is VALUE_PARAM_E, absolute address if type is VALUE_ADDR_E
 };
 
 /**
- * Pre-allocate initial space for expanded assembly.
- *
- * @param base Expanded assembly to pre-allocate space for.
- * @param parsed Parsed assembly to determine size of space to pre-allocate.
+ * Macro template relocation, patching an instruction when the template is expanded.
  */
-static struct expanded_base* expanded_base_alloc(struct expanded_base* base, const struct parsed_base parsed)
-{
-	if (!base)
-		return NULL;
+struct template_reloc {
+	size_t offset; // Index of instruction to patch within template
+	struct template_value value;
+};
 
-	// Failure to pre-allocate space for macros is critical
-	// Dynamic array resizes done after pre-allocate invalidates any expanded_base.parent pointing to a macro
-	// TODO: Rework expanded_base struct to handle dynamic array resizes
-	if (parsed.refs_macros.len > 0 && dynarr_alloc(&base->macros, parsed.refs_macros.capacity, sizeof(struct expanded_base)) == 0)
-		return NULL;
+/**
+ * Macro referenced within macro template, expanded when the template is expanded.
+ */
+struct template_call {
+	size_t offset; // Index of instruction within template the referenced macro is expanded before
+	size_t def_ind; // Index of parsed macro definition referenced
+	size_t line_num; // Number of line in file referencing macro
+	size_t args_ind; // Index of first argument within template
+	size_t args_len; // Number of arguments, one argument per macro parameter
+};
 
-	// Failure to pre-allocate space is non-critical - not checking return results
-	dynarr_alloc(&base->lines, parsed.lines.capacity, sizeof(struct expanded_line));
-	dynarr_alloc(&base->refs_data, parsed.refs_data.capacity, sizeof(char[PARSED_KEY_CHARS]));
-	dynarr_alloc(&base->defs_data, parsed.defs_data.capacity, sizeof(struct parsed_def_data));
+/**
+ * Macro template, a macro definition compiled once.
+ * Expanding the template copies its instructions, patches its relocations and expands the macros it references.
+ */
+struct template {
+	enum template_state state;
+	size_t len; // Number of instructions once expanded, including referenced macros. SIZE_MAX if too many to count
+	struct dynarr insts; // Dynamic array of ngc_word_t, instructions with relocations unpatched
+	struct dynarr line_nums; // Dynamic array of size_t, number of line in file of each instruction
+	struct dynarr relocs; // Dynamic array of template_reloc, in order of offset
+	struct dynarr calls; // Dynamic array of template_call, in order of offset
+	struct dynarr args; // Dynamic array of template_value, arguments of each call
+};
 
-	// No space pre-allocated for macro parameters
+/**
+ * Frame of macro template being compiled.
+ */
+struct template_frame {
+	size_t def_ind; // Index of parsed macro definition being compiled
+	struct parsed_lines_iter iter; // Position of macro definition line being compiled
+};
 
-	return base;
-}
+/**
+ * Macro templates of parsed file.
+ */
+struct templates {
+	struct template root; // Template of root/file scope
+	struct dynarr root_defs_data; // Dynamic array of parsed_def_data, root/file data definitions with labels offset
+	struct dynarr vals; // Dynamic array of template, same order as parsed macro definitions
+	struct dynarr frames; // Dynamic array of template_frame, each frame compiling a macro referenced by the previous frame
+};
 
-static void expanded_base_empty_v(void* p); // forward declaration for trampoline used below
+/**
+ * Frame of macro template being expanded.
+ */
+struct expand_frame {
+	const struct template* tmpl;
+	size_t base; // Absolute address of first instruction of expanded template
+	size_t args_ind; // Index of first argument of template within resolved arguments
+	size_t insts_ind; // Index of next instruction of template to copy
+	size_t relocs_ind; // Index of next relocation of template to patch
+	size_t calls_ind; // Index of next call of template to expand
+};
+
+/**
+ * Job assembling part of the root/file template, from one macro reference of the file up to the macro reference the next job starts at.
+ * Jobs assemble disjoint instructions, so can be assembled concurrently.
+ */
+struct assemble_job {
+	struct expand_frame start; // Frame of root/file template the job starts from
+	size_t out_ind; // Index of first instruction assembled by job
+	size_t calls_end; // Index of root/file call job ends before
+	size_t insts_end; // Index of root/file instruction job ends before
+	struct dynarr relocs; // Dynamic array of assemble_reloc, relocations of instructions assembled by job if file is linked
+	struct error err;
+	size_t result; // 0 if successfully assembled. >0 line number if error
+};
+
+/**
+ * Jobs assembling parsed file.
+ */
+struct assemble_jobs {
+	struct dynarr vals; // Dynamic array of assemble_job, in order of instructions assembled
+	const struct templates* templates;
+	const struct parsed_file* file;
+	struct dynarr* instructions;
+	bool link; // Whether file is linked, leaving relocations of instructions to be patched once linked
+};
+
+DYNARR_DEFINE(struct template, template)
+DYNARR_DEFINE(struct template_value, template_value)
+DYNARR_DEFINE(struct template_reloc, template_reloc)
+DYNARR_DEFINE(struct template_call, template_call)
+DYNARR_DEFINE(struct template_frame, template_frame)
+DYNARR_DEFINE(struct expand_frame, expand_frame)
+DYNARR_DEFINE(struct assemble_job, assemble_job)
 
 /**
- * Free values within expanded assembly.
+ * Free values within macro template.
  */
-static void expanded_base_empty(struct expanded_base* base)
+static void template_empty(struct template* tmpl)
 {
-	if (!base)
+	if (!tmpl)
 		return;
 
-	base->parent = NULL;
-	dynarr_empty(&base->lines);
-	dynarr_delegate_empty(&base->macros, expanded_base_empty_v);
-	dynarr_empty(&base->params);
-	dynarr_empty(&base->refs_data);
-	dynarr_empty(&base->defs_data);
+	dynarr_empty(&tmpl->insts);
+	dynarr_empty(&tmpl->line_nums);
+	dynarr_empty(&tmpl->relocs);
+	dynarr_empty(&tmpl->calls);
+	dynarr_empty(&tmpl->args);
 }
 
-static void expanded_base_empty_v(void* p) { expanded_base_empty(p); }
+static void template_empty_v(void* p) { template_empty(p); }
 
 /**
- * Get expanded macro parameter from dynamic array using key.
- *
- * @param defs_macros Dynamic array of expanded macro parameters.
- * @param key Key of macro parameter to get.
- * @returns Pointer to expanded macro parameter. NULL if not found.
+ * Free values within assembly job.
  */
-static struct expanded_macro_param* expanded_macro_param_get(const struct dynarr params, const char* key)
+static void assemble_job_empty(struct assemble_job* job)
 {
-	if (!key)
-		return NULL;
+	if (!job)
+		return;
 
-	for (size_t param_ind = 0; param_ind < params.len; param_ind++) {
-		struct expanded_macro_param* param = dynarr_get(params, param_ind);
-		if (!param)
-			continue;
+	dynarr_empty(&job->relocs);
+}
 
-		if (PARSED_KEYS_EQ(param->key, key))
-			return param;
+static void assemble_job_empty_v(void* p) { assemble_job_empty(p); }
+
+/**
+ * Push relocation of assembled instruction.
+ *
+ * @param err Struct to store error.
+ * @param relocs Dynamic array of assemble_reloc to push relocation to.
+ * @param type Type of relocation.
+ * @param offset Index of assembled instruction to patch.
+ * @param key Interned key of data reference if type is RELOC_SYMBOL_E.
+ * @returns Whether relocation was pushed successfully.
+ */
+static bool reloc_push(struct error* err, struct dynarr* relocs, const enum assemble_reloc_type type, const size_t offset, const symbol_t key)
+{
+	struct assemble_reloc reloc = { .type = type, .offset = offset, .key = key };
+	if (!dynarr_assemble_reloc_push(relocs, reloc)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push relocation");
+		return false;
 	}
 
-	return NULL;
+	return true;
 }
 
 /**
- * Push expanded line.
+ * Add number of instructions to length of expanded macro template, saturating instead of overflowing.
+ */
+static void template_len_add(struct template* tmpl, const size_t len)
+{
+	tmpl->len = (len < SIZE_MAX - tmpl->len) ? tmpl->len + len : SIZE_MAX;
+}
+
+/**
+ * Push instruction to macro template.
  *
  * @param err Struct to store error.
- * @param lines Dynamic array to store expanded result.
- * @param type Type of expanded line.
+ * @param tmpl Macro template to push instruction to.
+ * @param value Value of instruction, patched by a relocation if not constant.
  * @param line_num Number of line in file.
- * @param val Expanded line value.
- * @returns Whether expanded line was pushed successfully.
+ * @returns Whether instruction was pushed successfully.
  */
-static bool lines_push(struct error* err, struct dynarr* lines, const enum parsed_line_type type, const size_t line_num, const size_t val)
+static bool template_inst_push(struct error* err, struct template* tmpl, const struct template_value value, const size_t line_num)
 {
-	struct expanded_line result = { .type = type, .line_num = line_num, .val = val };
-	if (!dynarr_push(lines, &result, sizeof(result))) {
-		error_init(err, ERRVAL_FAILURE, "Failed to push expanded line");
+	ngc_word_t inst = (value.type == VALUE_CONST_E) ? (ngc_word_t)value.val : 0;
+	if (!dynarr_word_push(&tmpl->insts, inst)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push template instruction");
 		return false;
 	}
 
+	if (!dynarr_size_push(&tmpl->line_nums, line_num)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push template line number");
+		return false;
+	}
+
+	struct template_reloc reloc = { .offset = tmpl->insts.len - 1, .value = value };
+	if (value.type != VALUE_CONST_E && !dynarr_template_reloc_push(&tmpl->relocs, reloc)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push template relocation");
+		return false;
+	}
+
+	template_len_add(tmpl, 1);
 	return true;
 }
 
 /**
- * Expand/unwind macros from parsed result.
+ * Get macro definition referenced by line, validating the reference.
  *
  * @param err Struct to store error.
- * @param expanded Struct to store expanded/unwound result.
- * @param parsed Parsed assembly.
- * @param defs_macros Dynamic array of parsed macro definitions.
- * @param depth Number of recursions deep the expansion/unwinding is being performed at.
- * @returns 0 if successfully expanded/unwound. >0 line number if error.
+ * @param def_ind Index of parsed macro definition to store result.
+ * @param ref_macro Parsed macro reference to store result.
+ * @param file Parsed file.
+ * @param base Parsed assembly containing line.
+ * @param line Parsed line referencing macro.
+ * @returns 0 if macro reference is valid. >0 line number if error.
  */
-static size_t expand_parsed(struct error* err, struct expanded_base* expanded, const struct parsed_base parsed, const struct dynarr defs_macros, const size_t depth)
+static size_t ref_macro_get(struct error* err, size_t* def_ind, struct parsed_ref_macro** ref_macro, const struct parsed_file file, const struct parsed_base base, const struct parsed_line line)
 {
-	assert(expanded);
-
-	// Enforce max recursive calls to prevent stack overflow
-	if (depth > MACRO_DEPTH_MAX) {
-		error_init(err, ERRVAL_SYNTAX, "Macro depth limit exceeded (max %zu)", MACRO_DEPTH_MAX);
-		return (expanded->line_num > 0) ? expanded->line_num : 1;
+	// Get macro referenced by line
+	*ref_macro = dynarr_parsed_ref_macro_get(&base.refs_macros, line.val);
+	if (!*ref_macro) {
+		error_init(err, ERRVAL_FAILURE, "Macro reference index out of range: %zu", line.val);
+		return line.line_num;
 	}
 
-	// Copy data references as-is
-	if (parsed.refs_data.len > 0 && !dynarr_set(&expanded->refs_data, expanded->refs_data.len, parsed.refs_data.vals, parsed.refs_data.len, parsed.refs_data.val_size)) {
-		error_init(err, ERRVAL_FAILURE, "Failed to copy data references");
-		return (expanded->line_num > 0) ? expanded->line_num : 1;
+	// Get macro definition using macro reference key
+	long long def_macro_ind = keymap_get(file.defs_macros_map, (*ref_macro)->key);
+	struct parsed_def_macro* def_macro = (def_macro_ind >= 0) ? dynarr_parsed_def_macro_get(&file.defs_macros, (size_t)def_macro_ind) : NULL;
+	if (!def_macro) {
+		error_init(err, ERRVAL_SYNTAX, "Macro reference not defined: '%s'", symbols_key(file.syms, (*ref_macro)->key));
+		return line.line_num;
 	}
 
-	// Iterate through lines
-	for (size_t lines_ind = 0; lines_ind < parsed.lines.len; lines_ind++) {
-		struct parsed_line* line = dynarr_get(parsed.lines, lines_ind);
-		if (!line)
-			continue;
-
-		switch (line->type) {
-			case LINE_INST_E:
-			case LINE_REF_DATA_E:
-				// Push line as-is
-				if (!lines_push(err, &expanded->lines, line->type, line->line_num, line->val))
-					return line->line_num;
-
-				expanded->inst_len++;
-				break;
+	// Validate correct number of parameters are provided
+	if ((*ref_macro)->params.len < def_macro->params.len) {
+		error_init(err, ERRVAL_SYNTAX, "Macro reference has %zu too few parameters", def_macro->params.len - (*ref_macro)->params.len);
+		return line.line_num;
+	} else if ((*ref_macro)->params.len > def_macro->params.len) {
+		error_init(err, ERRVAL_SYNTAX, "Macro reference has %zu too many parameters", (*ref_macro)->params.len - def_macro->params.len);
+		return line.line_num;
+	}
 
-			case LINE_REF_MACRO_E:
-				;
-				// Get macro referenced by line
-				struct parsed_ref_macro* ref_macro = dynarr_get(parsed.refs_macros, line->val);
-				if (!ref_macro) {
-					error_init(err, ERRVAL_FAILURE, "Macro reference index out of range: %zu", line->val);
-					return line->line_num;
-				}
+	*def_ind = (size_t)def_macro_ind;
+	return 0;
+}
 
-				// Get macro definition using macro reference key
-				struct parsed_def_macro* def_macro = parsed_def_macro_get(defs_macros, ref_macro->key);
-				if (!def_macro) {
-					error_init(err, ERRVAL_SYNTAX, "Macro reference not defined: '%s'", ref_macro->key);
-					return line->line_num;
-				}
+/**
+ * Copy data definitions of parsed assembly, adding the instructions of referenced macros to labels.
+ *
+ * @param err Struct to store error.
+ * @param defs_data Dynamic array to store copied data definitions, in the same order as the parsed data definitions.
+ * @param base Parsed assembly.
+ * @param templates Macro templates of parsed file, compiled for all macros referenced by parsed assembly.
+ * @param file Parsed file.
+ * @returns Whether data definitions were copied successfully.
+ */
+static bool defs_data_offset(struct error* err, struct dynarr* defs_data, const struct parsed_base base, const struct templates templates, const struct parsed_file file)
+{
+	// Failure to pre-allocate space is non-critical - not checking return result
+	if (base.defs_data.len > 0)
+		dynarr_alloc(defs_data, base.defs_data.len, sizeof(struct parsed_def_data));
 
-				// Build initial expanded macro
-				struct expanded_base macro_expanded_init = { .parent = expanded, .line_num = line->line_num };
-				if (!expanded_base_alloc(&macro_expanded_init, def_macro->base)) {
-					error_init(err, ERRVAL_FAILURE, "Failed to init expanded macro struct");
-					return line->line_num;
-				}
+	size_t pc_offset = 0;
+	struct parsed_lines_iter iter = { 0 };
+	struct parsed_line line;
+	bool line_read = parsed_lines_next(&base.lines, &iter, &line);
+	for (size_t data_ind = 0; data_ind < base.defs_data.len; data_ind++) {
+		struct parsed_def_data* data = dynarr_parsed_def_data_get(&base.defs_data, data_ind);
+		if (!data)
+			continue;
 
-				// Expand macro parameters
-				if (ref_macro->params.len > 0 || def_macro->params.len > 0) {
-					// Validate correct number of parameters are provided
-					if (ref_macro->params.len < def_macro->params.len) {
-						error_init(err, ERRVAL_SYNTAX, "Macro reference has %zu too few parameters", def_macro->params.len - ref_macro->params.len);
-						return line->line_num;
-					} else if (ref_macro->params.len > def_macro->params.len) {
-						error_init(err, ERRVAL_SYNTAX, "Macro reference has %zu too many parameters", ref_macro->params.len - def_macro->params.len);
-						return line->line_num;
-					}
+		// Add number of instructions in macros referenced beforehand to program counter offset
+		for (; line_read && data->line_num >= line.line_num; line_read = parsed_lines_next(&base.lines, &iter, &line)) {
+			if (line.type != LINE_REF_MACRO_E)
+				continue;
+
+			struct parsed_ref_macro* ref_macro = dynarr_parsed_ref_macro_get(&base.refs_macros, line.val);
+			long long def_ind = (ref_macro) ? keymap_get(file.defs_macros_map, ref_macro->key) : -1;
+			struct template* tmpl = (def_ind >= 0) ? dynarr_template_get(&templates.vals, (size_t)def_ind) : NULL;
+			if (tmpl)
+				pc_offset = (tmpl->len < SIZE_MAX - pc_offset) ? pc_offset + tmpl->len : SIZE_MAX;
+		}
 
-					// Iterate through macro parameter definitions and references
-					for (size_t param_ind = 0; param_ind < ref_macro->params.len && param_ind < def_macro->params.len; param_ind++) {
-						struct parsed_ref_macro_param* param_ref = dynarr_get(ref_macro->params, param_ind);
-						char* param_def = dynarr_get(def_macro->params, param_ind);
+		struct parsed_def_data data_offset = *data;
+		if (data->type == DATA_LABEL_E)
+			data_offset.val += pc_offset;
 
-						if (!param_ref || !param_def)
-							continue;
+		if (!dynarr_parsed_def_data_push(defs_data, data_offset)) {
+			error_init(err, ERRVAL_FAILURE, "Failed to push data definition");
+			return false;
+		}
+	}
 
-						// Assemble expanded macro parameter
-						struct expanded_macro_param param = { .type = param_ref->type, .val = param_ref->val };
-						if (!str_copy(param.key, param_def, STR_CHARS(strlen(param_def)))) {
-							error_init(err, ERRVAL_FAILURE, "Failed to copy string");
-							return line->line_num;
-						}
+	return true;
+}
 
-						// Push expanded macro parameter
-						if (!dynarr_push(&macro_expanded_init.params, &param, sizeof(param))) {
-							error_init(err, ERRVAL_FAILURE, "Failed to push expanded macro parameter");
-							return line->line_num;
-						}
-					}
-				}
+/**
+ * Resolve data reference within macro template.
+ *
+ * @param def_macro Parsed macro definition of template. NULL if template of root/file scope.
+ * @param base Parsed assembly of template.
+ * @param defs_data Dynamic array of data definitions of template, with labels offset.
+ * @param file Parsed file.
+ * @param key Interned key of data reference.
+ * @param line_num Number of line in file.
+ * @returns Resolved value.
+ */
+static struct template_value template_ref_data(const struct parsed_def_macro* def_macro, const struct parsed_base base, const struct dynarr defs_data, const struct parsed_file file, const symbol_t key, const size_t line_num)
+{
+	struct template_value value = { .line_num = line_num, .key = key };
 
-				// Push initial expended macro to array
-				struct expanded_base* macro_expanded = dynarr_push(&expanded->macros, &macro_expanded_init, sizeof(macro_expanded_init));
-				if (!macro_expanded) {
-					error_init(err, ERRVAL_FAILURE, "Failed to push expanded macro");
-					return line->line_num;
-				}
+	// Try find macro parameter with matching key
+	long long param_ind = (def_macro && def_macro->params.len > 0) ? keymap_get(def_macro->params_map, key) : -1;
+	if (param_ind >= 0) {
+		value.type = VALUE_PARAM_E;
+		value.val = (size_t)param_ind;
+		return value;
+	}
 
-				// Push line referencing expanded macro
-				if (!lines_push(err, &expanded->lines, line->type, line->line_num, expanded->macros.len - 1))
-					return line->line_num;
+	struct parsed_def_data* data = parsed_def_data_get(defs_data, base.defs_data_map, key);
+	struct parsed_def_data* data_root = (def_macro) ? parsed_def_data_get(file.base.defs_data, file.base.defs_data_map, key) : NULL;
 
-				// Recusively build expanded macro
-				size_t macro_expanded_result = expand_parsed(err, macro_expanded, def_macro->base, defs_macros, depth + 1);
-				if (macro_expanded_result > 0)
-					return macro_expanded_result;
+	// Conflicting data is only reported if the instruction is assembled
+	if (data && data_root) {
+		value.type = VALUE_CONFLICT_E;
+		value.line_num = data->line_num;
+		return value;
+	}
 
-				expanded->inst_len += macro_expanded->inst_len;
-				break;
+	// Data found within template scope
+	if (data) {
+		value.type = (data->type == DATA_LABEL_E) ? VALUE_LABEL_E : VALUE_CONST_E;
+		value.val = data->val;
+		return value;
+	}
 
-			default:
-				error_init(err, ERRVAL_FAILURE, "Unknown line type: %d", line->type);
-				return line->line_num;
+	// Key does not refer to any macro parameter or data definition - try parse key as number
+	if (!data_root) {
+		const char* key_str = symbols_key(file.syms, key);
+		long parsed_number = parse_number(key_str, strlen(key_str));
+		if (parsed_number >= 0) {
+			value.type = VALUE_CONST_E;
+			value.val = (size_t)parsed_number;
+			return value;
 		}
 	}
 
-	// Use number of existing instructions as initial program counter offset
-	size_t pc_offset = 0;
-	for (struct expanded_base* parent = expanded->parent; parent; parent = parent->parent) {
-		pc_offset += parent->inst_len;
+	// Data found within root/file scope, or not defined - resolved when assembled
+	value.type = VALUE_REF_ROOT_E;
+	return value;
+}
+
+/**
+ * Build instructions, relocations and calls of macro template.
+ * All macros referenced by the template must already be compiled.
+ *
+ * @param err Struct to store error.
+ * @param tmpl Macro template to build.
+ * @param defs_data Dynamic array to store data definitions of template, with labels offset.
+ * @param def_macro Parsed macro definition of template. NULL if template of root/file scope.
+ * @param base Parsed assembly of template.
+ * @param templates Macro templates of parsed file.
+ * @param file Parsed file.
+ * @returns 0 if successfully built. >0 line number if error.
+ */
+static size_t template_build(struct error* err, struct template* tmpl, struct dynarr* defs_data, const struct parsed_def_macro* def_macro, const struct parsed_base base, const struct templates templates, const struct parsed_file file)
+{
+	// Template allocated from same arena as parsed file
+	tmpl->insts.arena = file.arena;
+	tmpl->line_nums.arena = file.arena;
+	tmpl->relocs.arena = file.arena;
+	tmpl->calls.arena = file.arena;
+	tmpl->args.arena = file.arena;
+	defs_data->arena = file.arena;
+
+	// Validate no macro parameter with same key as data definition exists
+	for (size_t data_ind = 0; def_macro && def_macro->params.len > 0 && data_ind < base.defs_data.len; data_ind++) {
+		struct parsed_def_data* data = dynarr_parsed_def_data_get(&base.defs_data, data_ind);
+		if (data && keymap_get(def_macro->params_map, data->key) >= 0) {
+			error_init(err, ERRVAL_SYNTAX, "Conflicting key given in DEFINE or LABEL statement, first used in macro parameter: '%s'", symbols_key(file.syms, data->key));
+			return data->line_num;
+		}
 	}
 
-	// Get first expanded macro, used to update program counter offset
-	size_t macro_ind = 0;
-	struct expanded_base* macro = dynarr_get(expanded->macros, macro_ind);
+	if (!defs_data_offset(err, defs_data, base, templates, file))
+		return (def_macro) ? def_macro->line_num : 1;
 
-	// Iterate through data definitions
-	for (size_t data_ind = 0; data_ind < parsed.defs_data.len; data_ind++) {
-		struct parsed_def_data* data = dynarr_get(parsed.defs_data, data_ind);
-		if (!data)
-			continue;
+	// Failure to pre-allocate space is non-critical - not checking return results
+	dynarr_alloc(&tmpl->insts, base.lines.vals.capacity, sizeof(ngc_word_t));
+	dynarr_alloc(&tmpl->line_nums, base.lines.vals.capacity, sizeof(size_t));
 
-		// Validate no macro parameter with same key already exists
-		if (expanded->params.len > 0 && expanded_macro_param_get(expanded->params, data->key)) {
-			error_init(err, ERRVAL_SYNTAX, "Conflicting key given in DEFINE or LABEL statement, first used in macro parameter: '%s'", data->key);
-			return data->line_num;
-		}
+	// Build template instructions
+	struct parsed_lines_iter iter = { 0 };
+	for (struct parsed_line line; parsed_lines_next(&base.lines, &iter, &line);) {
+		switch (line.type) {
+			case LINE_INST_E:
+				;
+				struct template_value inst = { .type = VALUE_CONST_E, .line_num = line.line_num, .val = line.val };
+				if (!template_inst_push(err, tmpl, inst, line.line_num))
+					return line.line_num;
 
-		// Add number of instructions in macros referenced beforehand to program counter offset
-		while (macro && data->line_num >= macro->line_num) {
-			pc_offset += macro->inst_len;
-			macro_ind++;
-			macro = dynarr_get(expanded->macros, macro_ind);
-		}
+				break;
 
-		switch (data->type) {
-			case DATA_CONST_E:
-				// Push data definition as-is
-				if (!dynarr_push(&expanded->defs_data, data, sizeof(*data))) {
-					error_init(err, ERRVAL_FAILURE, "Failed to push data definition");
-					return data->line_num;
+			case LINE_REF_DATA_E:
+				;
+				// Get referenced data key at given index
+				symbol_t* data_key = dynarr_symbol_get(&base.refs_data, line.val);
+				if (!data_key) {
+					error_init(err, ERRVAL_FAILURE, "Data reference index out of range: %zu", line.val);
+					return line.line_num;
 				}
 
-				break;
+				if (!template_inst_push(err, tmpl, template_ref_data(def_macro, base, *defs_data, file, *data_key, line.line_num), line.line_num))
+					return line.line_num;
 
-			case DATA_LABEL_E:
-				// No program counter offset to account for - push data definition as-is
-				if (pc_offset == 0) {
-					if (!dynarr_push(&expanded->defs_data, data, sizeof(*data))) {
-						error_init(err, ERRVAL_FAILURE, "Failed to push data definition");
-						return data->line_num;
-					}
+				break;
 
+			case LINE_REF_MACRO_E:
+				;
+				// Referenced macro already validated and compiled
+				struct parsed_ref_macro* ref_macro = dynarr_parsed_ref_macro_get(&base.refs_macros, line.val);
+				size_t ref_def_ind = (size_t)keymap_get(file.defs_macros_map, ref_macro->key);
+				struct template* ref_tmpl = dynarr_template_get(&templates.vals, ref_def_ind);
+				if (ref_tmpl->len == 0)
 					break;
-				}
 
-				// Assemble copy of data definition with program counter offset added
-				struct parsed_def_data data_offset = { .type = data->type, .line_num = data->line_num, .val = data->val + pc_offset };
-				if (!str_copy(data_offset.key, data->key, STR_SIZE(strlen(data->key)))) {
-					error_init(err, ERRVAL_FAILURE, "Failed to copy string");
-					return data->line_num;
+				struct template_call call = { .offset = tmpl->insts.len, .def_ind = ref_def_ind, .line_num = line.line_num, .args_ind = tmpl->args.len, .args_len = ref_macro->params.len };
+				if (!dynarr_template_call_push(&tmpl->calls, call)) {
+					error_init(err, ERRVAL_FAILURE, "Failed to push template call");
+					return line.line_num;
 				}
 
-				// Push data definition
-				if (!dynarr_push(&expanded->defs_data, &data_offset, sizeof(data_offset))) {
-					error_init(err, ERRVAL_FAILURE, "Failed to push data definition");
-					return data->line_num;
+				// Resolve arguments of referenced macro within this template
+				for (size_t param_ind = 0; param_ind < ref_macro->params.len; param_ind++) {
+					struct parsed_ref_macro_param* param = dynarr_parsed_ref_macro_param_get(&ref_macro->params, param_ind);
+					struct template_value arg = { .type = VALUE_CONST_E, .line_num = line.line_num, .val = param->val };
+
+					// Data key passed as macro parameter is resolved on the line referencing the macro
+					if (param->type == PARAM_REF_DATA_E) {
+						symbol_t* param_key = dynarr_symbol_get(&base.refs_data, param->val);
+						if (!param_key) {
+							error_init(err, ERRVAL_FAILURE, "Data reference index out of range: %zu", param->val);
+							return line.line_num;
+						}
+
+						arg = template_ref_data(def_macro, base, *defs_data, file, *param_key, line.line_num);
+					}
+
+					if (!dynarr_template_value_push(&tmpl->args, arg)) {
+						error_init(err, ERRVAL_FAILURE, "Failed to push template call argument");
+						return line.line_num;
+					}
 				}
 
+				template_len_add(tmpl, ref_tmpl->len);
 				break;
 
 			default:
-				error_init(err, ERRVAL_FAILURE, "Unknown data definition type: %d", data->type);
-				return data->line_num;
+				error_init(err, ERRVAL_FAILURE, "Unknown line type: %d", line.type);
+				return line.line_num;
 		}
 	}
 
@@ -334,223 +492,476 @@ static size_t expand_parsed(struct error* err, struct expanded_base* expanded, c
 }
 
 /**
- * Assemble expanded/unwound data reference.
+ * Compile parsed macro definition to macro template.
+ * Referenced macros are compiled first, using a stack of frames instead of recursion.
  *
  * @param err Struct to store error.
- * @param data_val Int to store NGC data instruction.
- * @param expanded Expanded/unwound assembly.
- * @param root Expanded/unwound root/file assembly. Should be NULL if `expanded` is the root/file.
- * @param line_num Number of line in file.
- * @param key Key of data reference to get.
- * @returns 0 if successfully assembled. >0 line number if error.
+ * @param templates Macro templates of parsed file.
+ * @param file Parsed file.
+ * @param def_ind Index of parsed macro definition to compile.
+ * @returns 0 if successfully compiled. >0 line number if error.
  */
-static size_t assemble_ref_data(struct error* err, size_t* data_val, const struct expanded_base expanded, const struct expanded_base* root, const size_t line_num, const char* key)
+static size_t template_compile(struct error* err, struct templates* templates, const struct parsed_file file, const size_t def_ind)
 {
-	assert(key);
-
-	if (root) {
-		assert(!root->parent);
-		assert(expanded.parent);
-	} else {
-		assert(!expanded.parent);
+	struct template_frame frame_init = { .def_ind = def_ind };
+	if (!dynarr_template_frame_push(&templates->frames, frame_init)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push macro template frame");
+		return 1;
 	}
 
-	// Try find macro parameter with matching key
-	if (expanded.parent && expanded.params.len > 0) {
-		struct expanded_macro_param* macro_param = expanded_macro_param_get(expanded.params, key);
-		if (macro_param) {
-			switch (macro_param->type) {
-				case PARAM_CONST_E:
-					*data_val = macro_param->val;
-					return 0;
-
-				case PARAM_REF_DATA_E:
-					;
-					// Get data key passed as macro parameter
-					char* parent_key = dynarr_get(expanded.parent->refs_data, macro_param->val);
-					if (!parent_key) {
-						error_init(err, ERRVAL_FAILURE, "Data reference index out of range: %zu", macro_param->val);
-						return line_num;
-					}
+	size_t frames_base = templates->frames.len - 1;
+	while (templates->frames.len > frames_base) {
+		// Frames are referenced by index - pushing a frame can move all frames
+		size_t frame_ind = templates->frames.len - 1;
+		struct template_frame* frame = dynarr_template_frame_get(&templates->frames, frame_ind);
+		struct template* tmpl = dynarr_template_get(&templates->vals, frame->def_ind);
+		struct parsed_def_macro* def_macro = dynarr_parsed_def_macro_get(&file.defs_macros, frame->def_ind);
+		assert(tmpl && def_macro);
+
+		tmpl->state = TEMPLATE_COMPILING_E;
+
+		// Compile referenced macros, resuming from the last macro referenced
+		bool frame_pushed = false;
+		struct parsed_lines_iter iter = frame->iter;
+		for (struct parsed_line line; parsed_lines_next(&def_macro->base.lines, &iter, &line); frame->iter = iter) {
+			if (line.type != LINE_REF_MACRO_E)
+				continue;
+
+			size_t ref_def_ind = 0;
+			struct parsed_ref_macro* ref_macro;
+			size_t result = ref_macro_get(err, &ref_def_ind, &ref_macro, file, def_macro->base, line);
+			if (result > 0)
+				return result;
+
+			// Macro being compiled references itself, either directly or through the macros it references
+			struct template* ref_tmpl = dynarr_template_get(&templates->vals, ref_def_ind);
+			if (ref_tmpl->state == TEMPLATE_COMPILING_E) {
+				error_init(err, ERRVAL_SYNTAX, "Macro reference is recursive: '%s'", symbols_key(file.syms, ref_macro->key));
+				return line.line_num;
+			}
 
-					// Assemble data reference passed as macro parameter.
-					return assemble_ref_data(err, data_val, *expanded.parent, expanded.parent->parent ? root : NULL, expanded.line_num, parent_key);
+			// Compile referenced macro first, then revisit this line
+			if (ref_tmpl->state == TEMPLATE_NONE_E) {
+				struct template_frame ref_frame = { .def_ind = ref_def_ind };
+				if (!dynarr_template_frame_push(&templates->frames, ref_frame)) {
+					error_init(err, ERRVAL_FAILURE, "Failed to push macro template frame");
+					return line.line_num;
+				}
 
-				default:
-					error_init(err, ERRVAL_FAILURE, "Unknown expanded macro parameter type: %d", macro_param->type);
-					return line_num;
+				frame_pushed = true;
+				break;
 			}
 		}
-	}
 
-	// Key does not refer to any macro parameter - get data definition within current scope with matching key
-	struct parsed_def_data* data = parsed_def_data_get(expanded.defs_data, key);
+		if (frame_pushed)
+			continue;
+
+		// All referenced macros compiled
+		struct dynarr defs_data = { 0 };
+		size_t result = template_build(err, tmpl, &defs_data, def_macro, def_macro->base, *templates, file);
+		dynarr_empty(&defs_data);
+		if (result > 0)
+			return result;
 
-	// No other scope to check (currently within root/file scope) - return data found within current scope
-	if (data && !root) {
-		*data_val = data->val;
-		return 0;
+		tmpl->state = TEMPLATE_COMPILED_E;
+		templates->frames.len--;
 	}
 
-	if (root) {
-		// Get data definition within root/file scope with matching key
-		struct parsed_def_data* data_root = parsed_def_data_get(root->defs_data, key);
-
-		// No data found in root/file scope - return data found within current scope
-		if (data && !data_root) {
-			*data_val = data->val;
-			return 0;
-		}
+	return 0;
+}
 
-		// No data found within current scope - return data found within root/file scope
-		if (data_root && !data) {
-			*data_val = data_root->val;
-			return 0;
-		}
+/**
+ * Assemble data reference within root/file scope.
+ *
+ * @param err Struct to store error.
+ * @param data_val Int to store NGC data instruction.
+ * @param relocs Dynamic array of assemble_reloc to push relocation of NGC data instruction to. NULL if file is not linked.
+ * @param offset Index of NGC data instruction within assembled instructions.
+ * @param defs_data Dynamic array of root/file data definitions, with labels offset.
+ * @param file Parsed file.
+ * @param line_num Number of line in file.
+ * @param key Interned key of data reference to get.
+ * @returns 0 if successfully assembled. >0 line number if error.
+ */
+static size_t assemble_ref_data(struct error* err, size_t* data_val, struct dynarr* relocs, const size_t offset, const struct dynarr defs_data, const struct parsed_file file, const size_t line_num, const symbol_t key)
+{
+	struct parsed_def_data* data = parsed_def_data_get(defs_data, file.base.defs_data_map, key);
+	if (data) {
+		// Labels are offset by the address the file is linked at
+		if (relocs && data->type == DATA_LABEL_E && !reloc_push(err, relocs, RELOC_BASE_E, offset, key))
+			return line_num;
 
-		// Conflicting data found in current and root/file scopes
-		if (data && data_root) {
-			error_init(err, ERRVAL_SYNTAX, "Conflicting key given in DEFINE or LABEL statement, first used on line %zu: '%s'", data_root->line_num, data_root->key);
-			return data->line_num;
-		}
+		*data_val = data->val;
+		return 0;
 	}
 
-	// Key does not refer to any macro parameter or data definition - try parse key as number
-	long parsed_number = parse_number(key, strlen(key));
+	// Key does not refer to any data definition - try parse key as number
+	const char* key_str = symbols_key(file.syms, key);
+	long parsed_number = parse_number(key_str, strlen(key_str));
 	if (parsed_number >= 0) {
 		*data_val = (size_t)parsed_number;
 		return 0;
 	}
 
-	error_init(err, ERRVAL_SYNTAX, "Data reference not defined: '%s'", key);
+	// Data reference resolved once linked
+	if (relocs) {
+		if (!reloc_push(err, relocs, RELOC_SYMBOL_E, offset, key))
+			return line_num;
+
+		*data_val = 0;
+		return 0;
+	}
+
+	error_init(err, ERRVAL_SYNTAX, "Data reference not defined: '%s'", key_str);
 	return line_num;
 }
 
 /**
- * Push NGC instruction.
+ * Assemble value of macro template being expanded.
  *
  * @param err Struct to store error.
- * @param instructions Dynamic array to push NGC instruction.
- * @param inst NGC instruction.
- * @returns Whether NGC instruction was pushed successfully.
+ * @param data_val Int to store NGC data instruction.
+ * @param relocs Dynamic array of assemble_reloc to push relocation of NGC data instruction to. NULL if file is not linked.
+ * @param offset Index of NGC data instruction within assembled instructions.
+ * @param args Dynamic array of template_value, resolved arguments of all frames being expanded.
+ * @param frame Frame expanding the template.
+ * @param value Value to assemble.
+ * @param templates Macro templates of parsed file.
+ * @param file Parsed file.
+ * @returns 0 if successfully assembled. >0 line number if error.
  */
-static bool inst_push(struct error* err, struct dynarr* instructions, const ngc_word_t inst)
+static size_t assemble_value(struct error* err, size_t* data_val, struct dynarr* relocs, const size_t offset, const struct dynarr args, const struct expand_frame frame, struct template_value value, const struct templates templates, const struct parsed_file file)
 {
-	if (!dynarr_push(instructions, &inst, sizeof(inst))) {
-		error_init(err, ERRVAL_FAILURE, "Failed to push assembled instruction");
-		return false;
+	// Arguments were resolved when the frame was pushed, so are never macro parameters themselves
+	if (value.type == VALUE_PARAM_E) {
+		struct template_value* arg = dynarr_template_value_get(&args, frame.args_ind + value.val);
+		if (!arg) {
+			error_init(err, ERRVAL_FAILURE, "Macro parameter index out of range: %zu", value.val);
+			return value.line_num;
+		}
+
+		value = *arg;
 	}
 
-	return true;
+	switch (value.type) {
+		case VALUE_CONST_E:
+			*data_val = value.val;
+			return 0;
+
+		case VALUE_LABEL_E:
+		case VALUE_ADDR_E:
+			// Labels are offset by the address the file is linked at
+			if (relocs && !reloc_push(err, relocs, RELOC_BASE_E, offset, value.key))
+				return value.line_num;
+
+			*data_val = (value.type == VALUE_LABEL_E) ? frame.base + value.val : value.val;
+			return 0;
+
+		case VALUE_REF_ROOT_E:
+			return assemble_ref_data(err, data_val, relocs, offset, templates.root_defs_data, file, value.line_num, value.key);
+
+		case VALUE_CONFLICT_E:
+			;
+			struct parsed_def_data* data_root = parsed_def_data_get(file.base.defs_data, file.base.defs_data_map, value.key);
+			struct parsed_loc loc = parsed_file_loc(file, value.line_num);
+			struct parsed_loc loc_first = parsed_file_loc(file, (data_root) ? data_root->line_num : 0);
+
+			// Source file of first line only given if it differs from source file of line
+			if (!loc.path || !loc_first.path || strcmp(loc.path, loc_first.path) == 0)
+				error_init(err, ERRVAL_SYNTAX, "Conflicting key given in DEFINE or LABEL statement, first used on line %zu: '%s'", (data_root) ? loc_first.line_num : 0, symbols_key(file.syms, value.key));
+			else
+				error_init(err, ERRVAL_SYNTAX, "Conflicting key given in DEFINE or LABEL statement, first used on line %zu of '%s': '%s'", loc_first.line_num, loc_first.path, symbols_key(file.syms, value.key));
+
+			return value.line_num;
+
+		default:
+			error_init(err, ERRVAL_FAILURE, "Unknown template value type: %d", value.type);
+			return value.line_num;
+	}
 }
 
 /**
- * Assemble expanded/unwound assembly to NGC instructions.
+ * Resolve arguments of macro referenced by frame, once for the whole expansion of the macro.
+ * Labels are resolved to their absolute address, and macro parameters to the arguments of the frame.
+ * Data references within root/file scope are left unresolved, only being reported if not defined when used.
  *
  * @param err Struct to store error.
- * @param instructions Dynamic array to push NGC instructions.
- * @param expanded Expanded/unwound assembly.
- * @returns 0 if successfully assembled. >0 line number if error.
+ * @param args Dynamic array of template_value to push resolved arguments.
+ * @param frame Frame referencing macro.
+ * @param call Macro referenced by frame.
+ * @returns Whether arguments were resolved successfully.
  */
-static size_t assemble_expanded(struct error* err, struct dynarr* instructions, const struct expanded_base expanded)
+static bool expand_args_push(struct error* err, struct dynarr* args, const struct expand_frame frame, const struct template_call call)
 {
-	// Find root/file scope
-	struct expanded_base* root = NULL;
-	if (expanded.parent)
-		for (root = expanded.parent; root->parent; root = root->parent);
-
-	// Iterate through lines
-	for (size_t lines_ind = 0; lines_ind < expanded.lines.len; lines_ind++) {
-		struct parsed_line* line = dynarr_get(expanded.lines, lines_ind);
-		if (!line)
-			continue;
+	for (size_t arg_ind = 0; arg_ind < call.args_len; arg_ind++) {
+		struct template_value arg = *dynarr_template_value_get(&frame.tmpl->args, call.args_ind + arg_ind);
+
+		if (arg.type == VALUE_PARAM_E) {
+			arg = *dynarr_template_value_get(args, frame.args_ind + arg.val);
+		} else if (arg.type == VALUE_LABEL_E) {
+			arg.type = VALUE_ADDR_E;
+			arg.val += frame.base;
+		}
 
-		switch (line->type) {
-			case LINE_INST_E:
-				if (!inst_push(err, instructions, (ngc_word_t)line->val))
-					return line->line_num;
+		if (!dynarr_template_value_push(args, arg)) {
+			error_init(err, ERRVAL_FAILURE, "Failed to push macro argument");
+			return false;
+		}
+	}
 
-				break;
+	return true;
+}
 
-			case LINE_REF_DATA_E:
-				;
-				// Get referenced data key at given index
-				char* data_key = dynarr_get(expanded.refs_data, line->val);
-				if (!data_key) {
-					error_init(err, ERRVAL_FAILURE, "Data reference index out of range: %zu", line->val);
-					return line->line_num;
-				}
+/**
+ * Assemble job, expanding macro templates using a stack of frames instead of recursion.
+ *
+ * @param job Job to assemble, storing its result.
+ * @param instructions Dynamic array of NGC instructions, with space already reserved for all instructions of the job.
+ * @param templates Compiled macro templates of parsed file.
+ * @param file Parsed file.
+ * @param link Whether file is linked, storing relocations of instructions within job.
+ */
+static void assemble_job(struct assemble_job* job, struct dynarr* instructions, const struct templates templates, const struct parsed_file file, const bool link)
+{
+	struct error* err = &job->err;
+	size_t out_ind = job->out_ind;
 
-				// Assemble data value
-				size_t data_val;
-				size_t data_result = assemble_ref_data(err, &data_val, expanded, root, line->line_num, data_key);
-				if (data_result > 0)
-					return data_result;
+	// Jobs may run concurrently - not allocating from arena of parsed file
+	struct dynarr frames = { 0 };
+	struct dynarr args = { 0 };
 
-				// Push data value
-				if (!inst_push(err, instructions, (ngc_word_t)data_val))
-					return line->line_num;
+	if (!dynarr_expand_frame_push(&frames, job->start)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push macro expansion frame");
+		job->result = 1;
+		goto exit;
+	}
 
-				break;
+	while (frames.len > 0) {
+		// Frames are referenced by index - pushing a frame can move all frames
+		size_t frame_ind = frames.len - 1;
+		struct expand_frame* frame = dynarr_expand_frame_get(&frames, frame_ind);
+		const struct template* tmpl = frame->tmpl;
+
+		// Job only assembles part of the root/file template
+		bool root = frame_ind == 0;
+		struct template_call* call = (!root || frame->calls_ind < job->calls_end) ? dynarr_template_call_get(&tmpl->calls, frame->calls_ind) : NULL;
+		size_t insts_end = (call) ? call->offset : (root) ? job->insts_end : tmpl->insts.len;
+
+		// Copy instructions up to next call, but only up to and including the first instruction exceeding the instruction limit
+		size_t insts_len = insts_end - frame->insts_ind;
+		if (out_ind + insts_len > NGC_UWORD_MAX)
+			insts_len = NGC_UWORD_MAX + 1 - out_ind;
+
+		if (insts_len > 0) {
+			ngc_word_t* insts = memcpy(dynarr_word_get(instructions, out_ind), dynarr_word_get(&tmpl->insts, frame->insts_ind), insts_len * sizeof(ngc_word_t));
+
+			// Patch relocations of copied instructions
+			for (struct template_reloc* reloc; (reloc = dynarr_template_reloc_get(&tmpl->relocs, frame->relocs_ind)) && reloc->offset < frame->insts_ind + insts_len; frame->relocs_ind++) {
+				size_t data_val = 0;
+				size_t inst_ind = out_ind + reloc->offset - frame->insts_ind;
+				job->result = assemble_value(err, &data_val, (link) ? &job->relocs : NULL, inst_ind, args, *frame, reloc->value, templates, file);
+				if (job->result > 0)
+					goto exit;
+
+				insts[reloc->offset - frame->insts_ind] = (ngc_word_t)data_val;
+			}
 
-			case LINE_REF_MACRO_E:
-				;
-				// Get referenced expanded macro at given index
-				struct expanded_base* macro = dynarr_get(expanded.macros, line->val);
-				if (!macro) {
-					error_init(err, ERRVAL_FAILURE, "Macro index out of range: %zu", line->val);
-					return line->line_num;
-				}
+			frame->insts_ind += insts_len;
+			out_ind += insts_len;
+			if (out_ind > NGC_UWORD_MAX) {
+				error_init(err, ERRVAL_FILE, "File contains too many instructions (max %zu)", NGC_UWORD_MAX);
+				job->result = *dynarr_size_get(&tmpl->line_nums, frame->insts_ind - 1);
+				goto exit;
+			}
+		}
 
-				// Recursively assemble macro
-				size_t macro_result = assemble_expanded(err, instructions, *macro);
-				if (macro_result > 0)
-					return macro_result;
+		// Template fully expanded
+		if (!call) {
+			args.len = frame->args_ind;
+			frames.len--;
+			continue;
+		}
 
-				break;
+		// Expand referenced macro, then resume this template
+		struct expand_frame frame_call = { .tmpl = dynarr_template_get(&templates.vals, call->def_ind), .base = out_ind, .args_ind = args.len };
+		frame->calls_ind++;
+		if (!expand_args_push(err, &args, *frame, *call)) {
+			job->result = call->line_num;
+			goto exit;
+		}
 
-			default:
-				error_init(err, ERRVAL_FAILURE, "Unknown line type: %d", line->type);
-				return line->line_num;
+		if (!dynarr_expand_frame_push(&frames, frame_call)) {
+			error_init(err, ERRVAL_FAILURE, "Failed to push macro expansion frame");
+			job->result = call->line_num;
+			goto exit;
 		}
+	}
+
+	exit:
+	dynarr_empty(&frames);
+	dynarr_empty(&args);
+}
+
+static void assemble_job_v(void* p, size_t job_ind)
+{
+	struct assemble_jobs* jobs = p;
+	assemble_job(dynarr_assemble_job_get(&jobs->vals, job_ind), jobs->instructions, *jobs->templates, *jobs->file, jobs->link);
+}
 
-		if (instructions->len > NGC_UWORD_MAX) {
-			error_init(err, ERRVAL_FILE, "File contains too many instructions (max %zu)", NGC_UWORD_MAX);
-			return line->line_num;
+/**
+ * Split root/file template into jobs, each starting at a macro reference of the file.
+ * Each job knows the index of its first instruction beforehand, so jobs can be assembled in any order.
+ *
+ * @param err Struct to store error.
+ * @param jobs Jobs to push to.
+ * @param templates Compiled macro templates of parsed file.
+ * @param split Whether to split into multiple jobs, rather than a single job assembling the whole file.
+ * @returns Whether jobs were pushed successfully.
+ */
+static bool assemble_jobs_push(struct error* err, struct assemble_jobs* jobs, const struct templates* templates, const bool split)
+{
+	const struct template* root = &templates->root;
+	struct assemble_job job = { .start = { .tmpl = root } };
+
+	size_t calls_len = 0; // Number of instructions of all macros referenced so far
+	for (size_t calls_ind = 0; calls_ind < root->calls.len && split; calls_ind++) {
+		struct template_call* call = dynarr_template_call_get(&root->calls, calls_ind);
+		size_t out_ind = (call->offset < SIZE_MAX - calls_len) ? call->offset + calls_len : SIZE_MAX;
+
+		// Instructions beyond the instruction limit are never assembled
+		if (out_ind > NGC_UWORD_MAX)
+			break;
+
+		// Start next job at macro reference once current job is large enough
+		if (out_ind - job.out_ind >= ASSEMBLE_JOB_LEN) {
+			job.calls_end = calls_ind;
+			job.insts_end = call->offset;
+			if (!dynarr_assemble_job_push(&jobs->vals, job))
+				goto error;
+
+			// Skip relocations of instructions before macro reference
+			size_t relocs_ind = job.start.relocs_ind;
+			struct template_reloc* reloc;
+			while ((reloc = dynarr_template_reloc_get(&root->relocs, relocs_ind)) && reloc->offset < call->offset) {
+				relocs_ind++;
+			}
+
+			job = (struct assemble_job){ .start = { .tmpl = root, .insts_ind = call->offset, .relocs_ind = relocs_ind, .calls_ind = calls_ind }, .out_ind = out_ind };
 		}
+
+		struct template* tmpl = dynarr_template_get(&templates->vals, call->def_ind);
+		calls_len = (tmpl->len < SIZE_MAX - calls_len) ? calls_len + tmpl->len : SIZE_MAX;
 	}
 
-	return 0;
+	job.calls_end = root->calls.len;
+	job.insts_end = root->insts.len;
+	if (!dynarr_assemble_job_push(&jobs->vals, job))
+		goto error;
+
+	return true;
+
+	error:
+	error_init(err, ERRVAL_FAILURE, "Failed to push assembly job");
+	return false;
 }
 
-size_t assemble_file_full(struct error* err, struct dynarr* instructions, const struct parsed_file file)
+size_t assemble_file_full(struct error* err, struct dynarr* instructions, const struct parsed_file file, struct assemble_link* link, const struct runner* runner)
 {
 	size_t result = 1;
-	struct expanded_base file_expanded = { 0 };
-	if (!expanded_base_alloc(&file_expanded, file.base)) {
-		error_init(err, ERRVAL_FAILURE, "Failed to init expanded file struct");
-		goto exit;
-	}
+	struct templates templates = { .vals = { .arena = file.arena }, .frames = { .arena = file.arena } };
+	struct assemble_jobs jobs = { .vals = { .arena = file.arena }, .templates = &templates, .file = &file, .instructions = instructions, .link = link != NULL };
 
 	if (!instructions) {
 		error_init(err, ERRVAL_FAILURE, "Instructions array is null");
 		goto exit;
 	}
 
-	// Expand/unwind macros from parsed result
-	result = expand_parsed(err, &file_expanded, file.base, file.defs_macros, 0);
-	if (result > 0)
+	// Macro templates are compiled when first referenced
+	if (file.defs_macros.len > 0 && !dynarr_alloc(&templates.vals, file.defs_macros.len, sizeof(struct template))) {
+		error_init(err, ERRVAL_FAILURE, "Failed to init macro templates");
 		goto exit;
+	}
+
+	templates.vals.len = file.defs_macros.len;
+
+	// Compile macros referenced by file
+	struct parsed_lines_iter iter = { 0 };
+	for (struct parsed_line line; parsed_lines_next(&file.base.lines, &iter, &line);) {
+		if (line.type != LINE_REF_MACRO_E)
+			continue;
+
+		size_t def_ind = 0;
+		struct parsed_ref_macro* ref_macro;
+		result = ref_macro_get(err, &def_ind, &ref_macro, file, file.base, line);
+		if (result > 0)
+			goto exit;
+
+		struct template* tmpl = dynarr_template_get(&templates.vals, def_ind);
+		if (tmpl->state == TEMPLATE_NONE_E) {
+			result = template_compile(err, &templates, file, def_ind);
+			if (result > 0)
+				goto exit;
+		}
+	}
 
-	// Assemble instructions from expanded/unwound result
-	result = assemble_expanded(err, instructions, file_expanded);
+	// Compile file itself as the template all macros are expanded from
+	result = template_build(err, &templates.root, &templates.root_defs_data, NULL, file.base, templates, file);
 	if (result > 0)
 		goto exit;
 
-	// Success
+	// Reserve space for all instructions up to and including the first instruction exceeding the instruction limit
+	ngc_word_t inst_last = 0;
+	size_t insts_len = (templates.root.len > NGC_UWORD_MAX) ? NGC_UWORD_MAX + 1 : templates.root.len;
+	if (insts_len > 0 && !dynarr_set(instructions, insts_len - 1, &inst_last, 1, sizeof(inst_last))) {
+		error_init(err, ERRVAL_FAILURE, "Failed to reserve assembled instructions");
+		result = 1;
+		goto exit;
+	}
+
+	// Assemble instructions, expanding macro templates
+	result = 1;
+	if (!assemble_jobs_push(err, &jobs, &templates, runner != NULL))
+		goto exit;
+
+	if (runner && jobs.vals.len > 1)
+		runner->run(runner->ctx, assemble_job_v, &jobs, jobs.vals.len);
+	else
+		assemble_job_v(&jobs, 0);
+
+	// Report first error in order of instructions, the same error as assembling the jobs in order
+	for (size_t job_ind = 0; job_ind < jobs.vals.len; job_ind++) {
+		struct assemble_job* job = dynarr_assemble_job_get(&jobs.vals, job_ind);
+		if (job->result > 0) {
+			*err = job->err;
+			result = job->result;
+			goto exit;
+		}
+	}
+
+	if (link) {
+		// Relocations of jobs are in order of offset, as jobs assemble instructions in order
+		for (size_t job_ind = 0; job_ind < jobs.vals.len; job_ind++) {
+			struct assemble_job* job = dynarr_assemble_job_get(&jobs.vals, job_ind);
+			if (job->relocs.len > 0 && !dynarr_set(&link->relocs, link->relocs.len, job->relocs.vals, job->relocs.len, sizeof(struct assemble_reloc))) {
+				error_init(err, ERRVAL_FAILURE, "Failed to push relocations");
+				goto exit;
+			}
+		}
+
+		// Export root/file data definitions, labels offset by referenced macros
+		if (templates.root_defs_data.len > 0 && !dynarr_set(&link->exports, 0, templates.root_defs_data.vals, templates.root_defs_data.len, sizeof(struct parsed_def_data))) {
+			error_init(err, ERRVAL_FAILURE, "Failed to push exported data definitions");
+			goto exit;
+		}
+	}
+
 	result = 0;
 
 	exit:
-	expanded_base_empty(&file_expanded);
+	template_empty(&templates.root);
+	dynarr_empty(&templates.root_defs_data);
+	dynarr_delegate_empty(&templates.vals, template_empty_v);
+	dynarr_empty(&templates.frames);
+	dynarr_delegate_empty(&jobs.vals, assemble_job_empty_v);
 	return result;
 }
@@ -1,8 +1,10 @@
 #ifndef ASSEMBLE_FULL_H
 #define ASSEMBLE_FULL_H
 
+#include "assemble.h"
 #include "err.h"
 #include "parsed.h"
+#include "runner.h"
 
 /**
  * Assemble parsed file to NGC instructions.
@@ -10,8 +12,10 @@
  * @param error Struct to store error.
  * @param instructions Dynamic array to push NGC instructions.
  * @param file Parsed file.
+ * @param link Struct to store linkage of file. NULL to assemble ROM.
+ * @param runner Runner of assembly jobs. NULL to assemble on the calling thread.
  * @returns 0 if successfully assembled. >0 line number if error.
  */
-size_t assemble_file_full(struct error* err, struct dynarr* instructions, const struct parsed_file file);
+size_t assemble_file_full(struct error* err, struct dynarr* instructions, const struct parsed_file file, struct assemble_link* link, const struct runner* runner);
 
 #endif
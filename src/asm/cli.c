@@ -1,19 +1,308 @@
 #define _XOPEN_SOURCE 600
 
+#include "../arena.h"
 #include "../ngc.h"
+#include "../object.h"
 #include "../print.h"
 #include "assemble.h"
 #include "parse.h"
 
+#include <errno.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 
+#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+#include <sys/mman.h>
+#endif
+
+#if defined(_POSIX_THREADS) && _POSIX_THREADS > 0
+#include <pthread.h>
+#endif
+
 #define PATH_STDIN "-"
 #define PATH_STDOUT "-"
 
+#define IN_CHUNK_SIZE 0x10000
+
+#define JOBS_MAX 0x100
+
+#define WATCH_INTERVAL_NS 100000000L // Interval between checking watched files for changes
+
+#define CACHE_TMP_SUFFIX ".XXXXXX" // Suffix of temporary file a cached record is written to, replaced by mkstemp()
+
+/**
+ * Contents of input file.
+ */
+struct in_buf {
+	char* str; // Not null-terminated
+	size_t len;
+	bool mapped; // Whether str is memory-mapped rather than allocated
+};
+
+/**
+ * Read whole input file to buffer.
+ * Regular files are memory-mapped where supported and allowed, otherwise the file is read in chunks.
+ *
+ * @param buf Buffer to store file contents.
+ * @param fp File pointer to read.
+ * @param map Whether file may be memory-mapped. Files which may be truncated while being parsed should not be mapped, as accessing truncated pages raises SIGBUS.
+ * @returns Whether file was read successfully.
+ */
+static bool in_buf_read(struct in_buf* buf, FILE* fp, const bool map)
+{
+	*buf = (struct in_buf){ 0 };
+	int fd = fileno(fp);
+
+	#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+	// Map regular files which have not been read from yet
+	struct stat st;
+	if (map && fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && (uintmax_t)st.st_size <= SIZE_MAX && lseek(fd, 0, SEEK_CUR) == 0) {
+		void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			buf->str = map;
+			buf->len = (size_t)st.st_size;
+			buf->mapped = true;
+			return true;
+		}
+	}
+	#else
+	(void)fd;
+	(void)map;
+	#endif
+
+	// Fall back to reading file in chunks, e.g. pipes
+	size_t capacity = 0;
+	for (;;) {
+		// Increase capacity to fit next chunk
+		if (capacity - buf->len < IN_CHUNK_SIZE) {
+			size_t capacity_new = (capacity > 0) ? capacity * 2 : IN_CHUNK_SIZE;
+			char* str_new = realloc(buf->str, capacity_new);
+			if (!str_new)
+				goto error;
+
+			buf->str = str_new;
+			capacity = capacity_new;
+		}
+
+		size_t read_len = fread(&buf->str[buf->len], sizeof(char), capacity - buf->len, fp);
+		buf->len += read_len;
+
+		if (read_len == 0)
+			break;
+	}
+
+	if (ferror(fp))
+		goto error;
+
+	return true;
+
+	error:
+	free(buf->str);
+	*buf = (struct in_buf){ 0 };
+	return false;
+}
+
+/**
+ * Free contents of input file.
+ */
+static void in_buf_empty(struct in_buf* buf)
+{
+	#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+	if (buf->mapped)
+		munmap(buf->str, buf->len);
+	else
+	#endif
+		free(buf->str);
+
+	*buf = (struct in_buf){ 0 };
+}
+
+/**
+ * Jobs shared between threads, each thread taking the next job not taken yet.
+ * Threads finishing their jobs early keep taking jobs, balancing jobs of uneven size.
+ */
+struct jobs_queue {
+	#if defined(_POSIX_THREADS) && _POSIX_THREADS > 0
+	pthread_mutex_t mutex;
+	#endif
+	size_t next; // Index of next job not taken yet
+	size_t len;
+	void (*job)(void*, size_t);
+	void* ctx;
+};
+
+/**
+ * Take and run jobs from queue until all jobs are taken.
+ */
+static void* jobs_queue_work(void* p)
+{
+	struct jobs_queue* queue = p;
+
+	for (;;) {
+		#if defined(_POSIX_THREADS) && _POSIX_THREADS > 0
+		pthread_mutex_lock(&queue->mutex);
+		#endif
+
+		size_t job_ind = queue->next;
+		if (job_ind < queue->len)
+			queue->next++;
+
+		#if defined(_POSIX_THREADS) && _POSIX_THREADS > 0
+		pthread_mutex_unlock(&queue->mutex);
+		#endif
+
+		if (job_ind >= queue->len)
+			return NULL;
+
+		queue->job(queue->ctx, job_ind);
+	}
+}
+
+/**
+ * Run jobs across threads, including the calling thread.
+ * Jobs are run on the calling thread only if threads are not supported.
+ *
+ * @param ctx Pointer to number of threads to run jobs across.
+ * @param job Function running job at index.
+ * @param jobs_ctx Context of jobs, passed to job function.
+ * @param jobs_len Number of jobs.
+ */
+static void jobs_run(void* ctx, void (*job)(void*, size_t), void* jobs_ctx, const size_t jobs_len)
+{
+	struct jobs_queue queue = { .len = jobs_len, .job = job, .ctx = jobs_ctx };
+
+	#if defined(_POSIX_THREADS) && _POSIX_THREADS > 0
+	size_t threads_len = *(size_t*)ctx;
+	pthread_t threads[JOBS_MAX];
+	size_t threads_started = 0;
+
+	// Run jobs on calling thread only if jobs cannot be shared
+	if (pthread_mutex_init(&queue.mutex, NULL) != 0) {
+		for (size_t job_ind = 0; job_ind < jobs_len; job_ind++) {
+			job(jobs_ctx, job_ind);
+		}
+
+		return;
+	}
+
+	// Calling thread is also a worker - failing to start a thread is non-critical
+	for (; threads_started + 1 < threads_len && threads_started + 1 < jobs_len; threads_started++) {
+		if (pthread_create(&threads[threads_started], NULL, jobs_queue_work, &queue) != 0)
+			break;
+	}
+
+	jobs_queue_work(&queue);
+
+	for (size_t thread_ind = 0; thread_ind < threads_started; thread_ind++) {
+		pthread_join(threads[thread_ind], NULL);
+	}
+
+	pthread_mutex_destroy(&queue.mutex);
+	#else
+	(void)ctx;
+	jobs_queue_work(&queue);
+	#endif
+}
+
+/**
+ * State of file watched for changes.
+ */
+struct watch_file {
+	size_t path; // Offset of null-terminated path within watch paths
+	bool exists;
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	time_t mtime;
+	time_t ctime;
+};
+
+DYNARR_DEFINE(struct watch_file, watch_file)
+
+/**
+ * Files watched for changes, the assembly file and all files it includes.
+ */
+struct watch {
+	struct dynarr paths; // Dynamic array of char, null-terminated paths of watched files
+	struct dynarr files; // Dynamic array of watch_file, state of each file when last assembled
+};
+
+/**
+ * Get state of watched file.
+ *
+ * @param path Offset of path within watch paths.
+ * @param path_str Null-terminated path.
+ * @returns State of file.
+ */
+static struct watch_file watch_file_stat(const size_t path, const char* path_str)
+{
+	struct watch_file file = { .path = path };
+	struct stat st;
+	if (stat(path_str, &st) != 0)
+		return file;
+
+	file.exists = true;
+	file.dev = st.st_dev;
+	file.ino = st.st_ino;
+	file.size = st.st_size;
+	file.mtime = st.st_mtime;
+	file.ctime = st.st_ctime;
+	return file;
+}
+
+/**
+ * Add file watched for changes, storing its current state.
+ * Files should be added before they are read, so changes made while they are read are detected.
+ * Files already watched keep the state stored before they were first read.
+ *
+ * @param watch Files watched for changes.
+ * @param path Null-terminated path of file to watch.
+ * @returns Whether file was added successfully.
+ */
+static bool watch_push(struct watch* watch, const char* path)
+{
+	for (size_t files_ind = 0; files_ind < watch->files.len; files_ind++) {
+		struct watch_file* file = dynarr_watch_file_get(&watch->files, files_ind);
+		if (strcmp(dynarr_char_get(&watch->paths, file->path), path) == 0)
+			return true;
+	}
+
+	size_t offset = watch->paths.len;
+	if (!dynarr_set(&watch->paths, offset, path, strlen(path) + 1, sizeof(char)))
+		return false;
+
+	struct watch_file file = watch_file_stat(offset, path);
+	return dynarr_watch_file_push(&watch->files, file) != NULL;
+}
+
+/**
+ * Check whether any watched file has changed since its state was stored.
+ * Files are compared by their status rather than contents, so the contents of files are not read again.
+ *
+ * @param watch Files watched for changes.
+ * @returns Whether any watched file has changed.
+ */
+static bool watch_changed(const struct watch watch)
+{
+	for (size_t files_ind = 0; files_ind < watch.files.len; files_ind++) {
+		struct watch_file* file = dynarr_watch_file_get(&watch.files, files_ind);
+		struct watch_file file_now = watch_file_stat(file->path, dynarr_char_get(&watch.paths, file->path));
+
+		if (file_now.exists != file->exists || file_now.dev != file->dev || file_now.ino != file->ino || file_now.size != file->size || file_now.mtime != file->mtime || file_now.ctime != file->ctime)
+			return true;
+	}
+
+	return false;
+}
+
+static bool assemble_stream_line_v(void* ctx, struct error* err, const struct parsed_file* file, const struct parsed_line line) { return assemble_stream_line(err, ctx, file, line); }
+
 /**
  * Print error associated with file.
  *
@@ -29,60 +318,178 @@ static void print_file_err(const char* f_path, const char* msg)
  * Print error result.
  *
  * @param f_path File path.
- * @param f_line Line of file.
- * @param msg Error message.
+ * @param f_line Line of parsed file, numbered across the file and all files it includes.
+ * @param err Error result.
+ * @param file Parsed file, to get file path and line within file of line.
  */
-static void print_err_err(const char* f_path, const size_t f_line, const struct error err)
+static void print_err_err(const char* f_path, const size_t f_line, const struct error err, const struct parsed_file file)
 {
-	if (err.val == ERRVAL_SYNTAX)
-		print_err("%s:%zu: %s", f_path, f_line, err.msg);
-	else
+	if (err.val == ERRVAL_SYNTAX) {
+		struct parsed_loc loc = parsed_file_loc(file, f_line);
+		print_err("%s:%zu: %s", (loc.path) ? loc.path : f_path, loc.line_num, err.msg);
+	} else
 		print_file_err(f_path, err.msg);
 }
 
-int main(int argc, char* argv[])
+/**
+ * Add file included by assembly file, before it is read.
+ */
+static void watch_include(void* ctx, const char* path)
 {
-	char* in_path = NULL;
-	char* out_path = NULL;
+	if (!watch_push(ctx, path))
+		print_file_err(path, "Failed to watch file");
+}
 
-	int opt;
-	extern char* optarg;
-	extern int optind, optopt;
+/**
+ * Get path of cached record within cache directory.
+ *
+ * @param dir Path of cache directory.
+ * @param key Key of record.
+ * @param suffix Suffix appended to path.
+ * @returns Allocated null-terminated path. NULL if error.
+ */
+static char* cache_path(const char* dir, const char* key, const char* suffix)
+{
+	size_t path_len = strlen(dir) + 1 + strlen(key) + strlen(suffix);
+	char* path = malloc(path_len + 1);
+	if (path)
+		sprintf(path, "%s/%s%s", dir, key, suffix);
 
-	// Set vars from opts
-	while ((opt = getopt(argc, argv, ":i:o:vV")) != -1) {
-		switch (opt) {
-			case 'o':
-				out_path = optarg;
-				break;
-			case 'v':
-			case 'V':
-				printf("ngc-asm v0.10.0%s", EOL);
-				return 0;
-			case ':':
-				print_err("Option -%c requires an argument", optopt);
-				return ERRVAL_ARGS;
-			case '?':
-				print_err("Unknown option: -%c", optopt);
-				return ERRVAL_ARGS;
-		}
+	return path;
+}
+
+/**
+ * Load cached record of included file from cache directory.
+ */
+static char* cache_load(void* ctx, const char* key, size_t* len)
+{
+	char* path = cache_path(ctx, key, "");
+	if (!path)
+		return NULL;
+
+	FILE* fp = fopen(path, "rb");
+	free(path);
+	if (!fp)
+		return NULL;
+
+	// Records may be replaced at any time by concurrent runs, so are not mapped
+	struct in_buf buf;
+	bool read = in_buf_read(&buf, fp, false);
+	fclose(fp);
+	if (!read)
+		return NULL;
+
+	*len = buf.len;
+	return buf.str;
+}
+
+/**
+ * Store cached record of included file to cache directory.
+ * Record is written to a temporary file then renamed, so concurrent runs never load a partially written record.
+ */
+static void cache_store(void* ctx, const char* key, const char* buf, size_t len)
+{
+	char* path = cache_path(ctx, key, "");
+	char* path_tmp = cache_path(ctx, key, CACHE_TMP_SUFFIX);
+	if (!path || !path_tmp)
+		goto exit;
+
+	int fd = mkstemp(path_tmp);
+	if (fd < 0)
+		goto exit;
+
+	FILE* fp = fdopen(fd, "wb");
+	if (!fp) {
+		close(fd);
+		unlink(path_tmp);
+		goto exit;
 	}
 
-	// Set input file path from arg
-	for (; optind < argc; optind++) {
-		if (in_path) {
-			print_err("Multiple assembly files given");
-			return ERRVAL_ARGS;
+	bool written = fwrite(buf, sizeof(char), len, fp) == len;
+	if (fclose(fp) != 0)
+		written = false;
+
+	if (!written || rename(path_tmp, path) != 0)
+		unlink(path_tmp);
+
+	exit:
+	free(path);
+	free(path_tmp);
+}
+
+/**
+ * Build object file from assembled file.
+ * Keys are copied from the symbol pool of the parsed file, so the object file outlives the parsed file.
+ *
+ * @param err Struct to store error.
+ * @param obj Struct to store object file, sharing the dynamic array of assembled instructions.
+ * @param instructions Dynamic array of assembled NGC instructions.
+ * @param link Linkage of assembled file.
+ * @param syms Symbol pool keys of parsed file were interned within.
+ * @returns Whether object file was built successfully.
+ */
+static bool object_build(struct error* err, struct object* obj, const struct dynarr instructions, const struct assemble_link link, const struct symbols syms)
+{
+	*obj = (struct object){ .insts = instructions };
+
+	// Failure to pre-allocate space is non-critical - not checking return results
+	if (link.exports.len > 0)
+		dynarr_alloc(&obj->symbols, link.exports.len, sizeof(struct object_symbol));
+	if (link.relocs.len > 0)
+		dynarr_alloc(&obj->relocs, link.relocs.len, sizeof(struct object_reloc));
+
+	for (size_t exports_ind = 0; exports_ind < link.exports.len; exports_ind++) {
+		struct parsed_def_data* data = dynarr_parsed_def_data_get(&link.exports, exports_ind);
+		struct object_symbol symbol = { .type = (data->type == DATA_LABEL_E) ? OBJECT_SYMBOL_LABEL_E : OBJECT_SYMBOL_CONST_E, .val = (ngc_uword_t)data->val };
+		snprintf(symbol.key, sizeof(symbol.key), "%s", symbols_key(syms, data->key));
+
+		if (!dynarr_object_symbol_push(&obj->symbols, symbol)) {
+			error_init(err, ERRVAL_FAILURE, "Failed to push object file symbol");
+			return false;
 		}
+	}
 
-		in_path = argv[optind];
+	for (size_t relocs_ind = 0; relocs_ind < link.relocs.len; relocs_ind++) {
+		struct assemble_reloc* reloc = dynarr_assemble_reloc_get(&link.relocs, relocs_ind);
+		struct object_reloc obj_reloc = { .type = (reloc->type == RELOC_SYMBOL_E) ? OBJECT_RELOC_SYMBOL_E : OBJECT_RELOC_BASE_E, .offset = (ngc_uword_t)reloc->offset };
+		if (reloc->type == RELOC_SYMBOL_E)
+			snprintf(obj_reloc.key, sizeof(obj_reloc.key), "%s", symbols_key(syms, reloc->key));
+
+		if (!dynarr_object_reloc_push(&obj->relocs, obj_reloc)) {
+			error_init(err, ERRVAL_FAILURE, "Failed to push object file relocation");
+			return false;
+		}
 	}
 
-	bool in_stdin = !in_path || strncmp(in_path, PATH_STDIN, strlen(PATH_STDIN) + 1) == 0;
-	char* in_name = in_stdin ? PATH_STDIN : in_path;
+	return true;
+}
+
+/**
+ * Assemble input file to output file.
+ *
+ * @param in_name Path of input file. PATH_STDIN to read from stdin.
+ * @param out_name Path of output file. PATH_STDOUT to output to stdout.
+ * @param out_object Whether to output object file rather than assembled instructions.
+ * @param runner Runner of parsing and assembly jobs. NULL to parse and assemble on the calling thread.
+ * @param watch Struct to store files to watch for changes, the input file and all files it includes. NULL if not watching files.
+ * @param cache Cache of pre-parsed included files. NULL if not caching included files.
+ * @returns 0 if successful, otherwise error value.
+ */
+static int assemble_path(const char* in_name, const char* out_name, const bool out_object, const struct runner* runner, struct watch* watch, const struct parse_cache* cache)
+{
+	bool in_stdin = strncmp(in_name, PATH_STDIN, strlen(PATH_STDIN) + 1) == 0;
+
+	// Watch input file, even if it cannot be opened yet, then all files it includes as they are read
+	if (watch) {
+		watch->paths.len = 0;
+		watch->files.len = 0;
+
+		if (!watch_push(watch, in_name))
+			print_file_err(in_name, "Failed to watch file");
+	}
 
 	// Open input file
-	FILE* in_fp = in_stdin ? stdin : fopen(in_path, "r");
+	FILE* in_fp = in_stdin ? stdin : fopen(in_name, "r");
 	if (!in_fp) {
 		print_file_err(in_name, "Failed to open file");
 		return ERRVAL_FILE;
@@ -90,52 +497,213 @@ int main(int argc, char* argv[])
 
 	struct error err = { 0 };
 
+	// All memory of parsed input file is owned by arena, freed at once when no longer needed
+	struct arena arena = { 0 };
+
 	// Initialise struct to store parsed input file
 	struct parsed_file file = { 0 };
-	parsed_file_alloc(&file);
+	parsed_file_alloc(&file, &arena);
 
-	// Parse input file
-	size_t parse_result = parse_file(&err, &file, in_fp, LANG_FEAT_ALL);
+	// Read whole input file - watched files may be truncated at any time, so are not mapped
+	struct in_buf in_buf;
+	bool in_read = in_buf_read(&in_buf, in_fp, !watch);
 	fclose(in_fp);
 
-	// Exit if any error occurred when parsing
-	if (parse_result > 0) {
-		print_err_err(in_name, parse_result, err);
-		parsed_file_empty(&file);
-		return err.val;
+	if (!in_read) {
+		print_file_err(in_name, "Failed to read file");
+		arena_empty(&arena);
+		return ERRVAL_FILE;
 	}
 
 	// Initialise dynamic array of assembled parsed file
 	struct dynarr instructions = { 0 };
 	dynarr_alloc(&instructions, 0x20, sizeof(ngc_word_t)); // Failure to pre-allocate space is non-critical - not checking return result
 
-	// Assemble parsed file
-	size_t assemble_result = assemble_file(&err, &instructions, file);
-	parsed_file_empty(&file);
+	// Macro-less files are assembled as they are parsed, unless outputting object file
+	struct assemble_stream stream = { .instructions = &instructions };
+	struct parse_stream parse_stream = { .line = assemble_stream_line_v, .ctx = &stream };
+
+	// Included files are watched even if they failed to be read
+	struct parse_watch parse_watch = { .include = watch_include, .ctx = watch };
+
+	// Parse input file
+	size_t parse_result = parse_file(&err, &file, in_buf.str, in_buf.len, in_name, LANG_FEAT_ALL, runner, (out_object) ? NULL : &parse_stream, (watch) ? &parse_watch : NULL, cache);
+	in_buf_empty(&in_buf);
+
+	// Exit if any error occurred when parsing
+	if (parse_result > 0) {
+		dynarr_empty(&instructions);
+		assemble_stream_empty(&stream);
+		print_err_err(in_name, parse_result, err, file);
+		arena_empty(&arena);
+		return err.val;
+	}
+
+	// Lines of file were only streamed if none are stored, otherwise instructions streamed before the file was parsed again are discarded
+	bool streamed = !out_object && file.base.lines.len == 0;
+	if (!streamed)
+		instructions.len = 0;
+
+	// Assemble parsed file, leaving data references not defined within file to be linked if outputting object file
+	struct assemble_link link = { 0 };
+	size_t assemble_result = (streamed) ? assemble_stream_end(&err, &stream, file) : assemble_file(&err, &instructions, file, (out_object) ? &link : NULL, runner);
+	assemble_stream_empty(&stream);
 
 	// Exit if any error occurred when assembling
 	if (assemble_result > 0) {
 		dynarr_empty(&instructions);
-		print_err_err(in_name, assemble_result, err);
+		assemble_link_empty(&link);
+		print_err_err(in_name, assemble_result, err, file);
+		arena_empty(&arena);
 		return err.val;
 	}
 
-	bool out_stdout = !out_path || strncmp(out_path, PATH_STDOUT, strlen(PATH_STDOUT) + 1) == 0;
-	char* out_name = out_stdout ? PATH_STDOUT : out_path;
+	// Build object file before the keys it exports are freed
+	struct object object = { 0 };
+	bool object_built = !out_object || object_build(&err, &object, instructions, link, file.syms);
+	assemble_link_empty(&link);
+	arena_empty(&arena);
+
+	if (!object_built) {
+		dynarr_empty(&object.symbols);
+		dynarr_empty(&object.relocs);
+		dynarr_empty(&instructions);
+		print_file_err(in_name, err.msg);
+		return err.val;
+	}
+
+	bool out_stdout = strncmp(out_name, PATH_STDOUT, strlen(PATH_STDOUT) + 1) == 0;
 
 	// Open output file
-	FILE* out_fp = out_stdout ? stdout : fopen(out_path, "wb");
+	FILE* out_fp = out_stdout ? stdout : fopen(out_name, "wb");
 	if (!out_fp) {
+		dynarr_empty(&object.symbols);
+		dynarr_empty(&object.relocs);
 		dynarr_empty(&instructions);
 		print_file_err(out_name, "Failed to open file");
 		return ERRVAL_FILE;
 	}
 
-	// Output assembled instructions
-	fwrite(instructions.vals, instructions.val_size, instructions.len, out_fp);
+	// Output assembled instructions, as object file if given
+	bool out_written = true;
+	if (out_object)
+		out_written = object_write(out_fp, object);
+	else
+		fwrite(instructions.vals, instructions.val_size, instructions.len, out_fp);
 
 	fclose(out_fp);
+
+	// Object file shares the dynamic array of assembled instructions
+	dynarr_empty(&object.symbols);
+	dynarr_empty(&object.relocs);
 	dynarr_empty(&instructions);
 
+	if (!out_written) {
+		print_file_err(out_name, "Failed to write file");
+		return ERRVAL_FILE;
+	}
+
 	return 0;
 }
+
+
+int main(int argc, char* argv[])
+{
+	char* in_path = NULL;
+	char* out_path = NULL;
+	char* cache_dir = NULL;
+	bool out_object = false;
+	bool watch_on = false;
+	size_t jobs_len = 1;
+
+	int opt;
+	extern char* optarg;
+	extern int optind, optopt;
+
+	// Set vars from opts
+	while ((opt = getopt(argc, argv, ":ci:j:o:p:vVw")) != -1) {
+		switch (opt) {
+			case 'c':
+				out_object = true;
+				break;
+			case 'j':
+				;
+				char* jobs_end;
+				unsigned long jobs_val = strtoul(optarg, &jobs_end, 10);
+				if (*optarg < '0' || *optarg > '9' || *jobs_end != '\0' || jobs_val < 1 || jobs_val > JOBS_MAX) {
+					print_err("Invalid number of jobs (min 1, max %d): %s", JOBS_MAX, optarg);
+					return ERRVAL_ARGS;
+				}
+
+				jobs_len = (size_t)jobs_val;
+				break;
+			case 'o':
+				out_path = optarg;
+				break;
+			case 'p':
+				cache_dir = optarg;
+				break;
+			case 'w':
+				watch_on = true;
+				break;
+			case 'v':
+			case 'V':
+				printf("ngc-asm v0.10.0%s", EOL);
+				return 0;
+			case ':':
+				print_err("Option -%c requires an argument", optopt);
+				return ERRVAL_ARGS;
+			case '?':
+				print_err("Unknown option: -%c", optopt);
+				return ERRVAL_ARGS;
+		}
+	}
+
+	// Set input file path from arg
+	for (; optind < argc; optind++) {
+		if (in_path) {
+			print_err("Multiple assembly files given");
+			return ERRVAL_ARGS;
+		}
+
+		in_path = argv[optind];
+	}
+
+	bool in_stdin = !in_path || strncmp(in_path, PATH_STDIN, strlen(PATH_STDIN) + 1) == 0;
+	bool out_stdout = !out_path || strncmp(out_path, PATH_STDOUT, strlen(PATH_STDOUT) + 1) == 0;
+	char* in_name = in_stdin ? PATH_STDIN : in_path;
+	char* out_name = out_stdout ? PATH_STDOUT : out_path;
+
+	// Parse and assemble input file across threads if multiple jobs given
+	struct runner runner = { .run = jobs_run, .ctx = &jobs_len };
+	const struct runner* runner_jobs = (jobs_len > 1) ? &runner : NULL;
+
+	// Pre-parsed included files are cached within directory if given, created if it does not exist
+	if (cache_dir && mkdir(cache_dir, 0777) != 0 && errno != EEXIST) {
+		print_file_err(cache_dir, "Failed to create cache directory");
+		return ERRVAL_FILE;
+	}
+
+	struct parse_cache cache = { .load = cache_load, .store = cache_store, .ctx = cache_dir };
+	const struct parse_cache* cache_on = (cache_dir) ? &cache : NULL;
+
+	if (!watch_on)
+		return assemble_path(in_name, out_name, out_object, runner_jobs, NULL, cache_on);
+
+	// Files are watched by path, and output is rewritten each time files change
+	if (in_stdin || out_stdout) {
+		print_err("Option -w requires paths to assembly and output files");
+		return ERRVAL_ARGS;
+	}
+
+	// Assemble again each time input file or any file it includes changes, until interrupted
+	struct watch watch = { 0 };
+	struct timespec interval = { .tv_sec = 0, .tv_nsec = WATCH_INTERVAL_NS };
+	assemble_path(in_name, out_name, out_object, runner_jobs, &watch, cache_on);
+
+	for (;;) {
+		nanosleep(&interval, NULL);
+		if (watch_changed(watch))
+			assemble_path(in_name, out_name, out_object, runner_jobs, &watch, cache_on);
+	}
+}
@@ -0,0 +1,97 @@
+#include "keymap.h"
+
+#include <stdlib.h>
+
+#define KEYMAP_CAPACITY_INIT 8
+#define KEYMAP_CAPACITY_INC(capacity) (capacity * 2)
+#define KEYMAP_FULL(map) ((map.len + 1) * 2 > map.capacity) // Keep load factor at most 1/2
+
+/**
+ * Calculate hash of interned key (Fibonacci hashing, folded so low bits depend on all bits of key).
+ */
+static size_t keymap_hash(const symbol_t key)
+{
+	uint32_t hash = key * 2654435769u;
+	return hash ^ (hash >> 16);
+}
+
+/**
+ * Insert slot into key map without resizing.
+ */
+static void keymap_insert(struct keymap* map, const struct keymap_slot slot)
+{
+	size_t mask = map->capacity - 1;
+	size_t slot_ind = keymap_hash(slot.key) & mask;
+
+	// Linear probe for unused slot
+	while (map->slots[slot_ind].ind != 0) {
+		slot_ind = (slot_ind + 1) & mask;
+	}
+
+	map->slots[slot_ind] = slot;
+	map->len++;
+}
+
+/**
+ * Resize key map, re-inserting all used slots.
+ */
+static bool keymap_resize(struct keymap* map, const size_t capacity)
+{
+	struct keymap_slot* slots = (map->arena) ? arena_alloc(map->arena, capacity * sizeof(*slots)) : calloc(capacity, sizeof(*slots));
+	if (!slots)
+		return false;
+
+	struct keymap old = *map;
+	map->slots = slots;
+	map->capacity = capacity;
+	map->len = 0;
+
+	for (size_t slot_ind = 0; slot_ind < old.capacity; slot_ind++) {
+		if (old.slots[slot_ind].ind != 0)
+			keymap_insert(map, old.slots[slot_ind]);
+	}
+
+	if (old.slots && !old.arena) free(old.slots);
+	return true;
+}
+
+long long keymap_get(const struct keymap map, const symbol_t key)
+{
+	if (map.len == 0)
+		return -1;
+
+	size_t mask = map.capacity - 1;
+
+	// Linear probe until matching key or unused slot found
+	for (size_t slot_ind = keymap_hash(key) & mask; map.slots[slot_ind].ind != 0; slot_ind = (slot_ind + 1) & mask) {
+		if (map.slots[slot_ind].key == key)
+			return (long long)map.slots[slot_ind].ind - 1;
+	}
+
+	return -1;
+}
+
+bool keymap_push(struct keymap* map, const symbol_t key, const size_t ind)
+{
+	if (!map)
+		return false;
+
+	// Increase capacity to keep probe sequences short
+	if (KEYMAP_FULL((*map)) && !keymap_resize(map, (map->capacity > 0) ? KEYMAP_CAPACITY_INC(map->capacity) : KEYMAP_CAPACITY_INIT))
+		return false;
+
+	struct keymap_slot slot = { .key = key, .ind = ind + 1 };
+	keymap_insert(map, slot);
+	return true;
+}
+
+void keymap_empty(struct keymap* map)
+{
+	if (!map)
+		return;
+
+	if (map->slots && !map->arena) free(map->slots);
+	map->slots = NULL;
+	map->capacity = 0;
+	map->len = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef KEYMAP_H
+#define KEYMAP_H
+
+#include "../arena.h"
+#include "symbols.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Slot of key map.
+ */
+struct keymap_slot {
+	symbol_t key; // Interned key
+	size_t ind; // Index of value in dynamic array + 1, 0 if slot is unused
+};
+
+/**
+ * Open-addressing hash map of interned keys to indexes of a dynamic array.
+ */
+struct keymap {
+	struct keymap_slot* slots;
+	size_t capacity; // Number of slots, always a power of 2
+	size_t len;
+	struct arena* arena; // Arena to allocate slots from, NULL to allocate slots individually
+};
+
+/**
+ * Get index of value in dynamic array using key.
+ *
+ * @param map Key map indexing dynamic array.
+ * @param key Interned key of value to get.
+ * @returns Index of value in dynamic array. -1 if not found.
+ */
+long long keymap_get(const struct keymap map, const symbol_t key);
+
+/**
+ * Add value of dynamic array to key map.
+ * Value should not share a key with any value already added.
+ *
+ * @param map Key map indexing dynamic array.
+ * @param key Interned key of value.
+ * @param ind Index of value in dynamic array.
+ * @returns Whether value was added to key map.
+ */
+bool keymap_push(struct keymap* map, const symbol_t key, const size_t ind);
+
+/**
+ * Free slots within key map.
+ * Key map will be in unallocated state once slots are freed.
+ * Slots allocated from an arena are only freed with the arena.
+ *
+ * @param map Key map to free slots of.
+ */
+void keymap_empty(struct keymap* map);
+
+#endif
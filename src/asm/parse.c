@@ -1,14 +1,29 @@
 #include "parse.h"
 
 #include "../ngc.h"
+#include "tokens.h"
+#include "tokens_table.h"
 
 #include <assert.h>
+#include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define FILE_LINES_MAX 0x100000
-#define FILE_COLS_MAX (0xFF - 2)
+#define PARSE_CHUNK_SIZE 0x40000 // Minimum size of each chunk of file pre-parsed concurrently
+#define INCLUDE_READ_SIZE 0x10000 // Size of each read of included file
+#define PARSE_CACHE_MAGIC 0x5043474EUL // "NGCP" in little-endian byte order, so records of other byte orders are not loaded
+#define PARSE_CACHE_VERSION 1 // Incremented whenever the format of records or the pre-parsed form of lines changes
+#define PARSE_CACHE_KEY_LEN 0x40 // Max length of key of cached record, including null char
+#define STREAM_LINES_LEN 0x100 // Number of lines of root/file scope stored before passing them to stream
+#define LINE_TOKS_CAPACITY_INIT 8 // Number of tokens of line pre-allocated, more than most statements and macro references
+#define NUM_LEN_MAX (0xFF - 2) // Max length of number token, allowing for leading zeros and underscores
+#define TOK_ERR_LEN_MAX ERRMSG_LEN_MAX // Max length of invalid token copied to error message, longer is truncated by message anyway
+#define TOK_ERR_LEN(len) (((len) < TOK_ERR_LEN_MAX) ? (len) : TOK_ERR_LEN_MAX)
+
+#define DIRECTIVE_INCLUDE "%INCLUDE" // Longer than tokens of token table, so matched separately
 
 enum parsed_scope {
 	SCOPE_FILE_E,
@@ -22,11 +37,101 @@ enum parse_inst_alu_result {
 	ALU_INST_HINT_REF_MACRO_E
 };
 
+/**
+ * Type of line pre-parsed within chunk of file.
+ */
+enum parse_chunk_line_type {
+	CHUNK_LINE_INST_E, // Instruction already parsed
+	CHUNK_LINE_INST_DATA_E, // Data instruction, key interned when parsed in order
+	CHUNK_LINE_DEFERRED_E // Any other line, parsed in order
+};
+
+/**
+ * Line pre-parsed within chunk of file, without interning keys or tracking scope.
+ */
+struct parse_chunk_line {
+	enum parse_chunk_line_type type;
+	size_t line_num; // Number of line within chunk
+	size_t val; // Parsed instruction if type is CHUNK_LINE_INST_E
+	struct str_view line_tr; // Line with leading and trailing whitespace trimmed
+};
+
+DYNARR_DEFINE(struct parse_chunk_line, chunk_line)
+
+/**
+ * Chunk of file split at line boundaries, pre-parsed concurrently with other chunks.
+ */
+struct parse_chunk {
+	const char* buf;
+	size_t len;
+	size_t lines_len; // Number of lines within chunk
+	struct dynarr lines; // Dynamic array of parse_chunk_line, empty and comment lines skipped
+	struct error err;
+	size_t result; // 0 if successfully pre-parsed. >0 number of line within chunk if error
+};
+
+DYNARR_DEFINE(struct parse_chunk, parse_chunk)
+
+/**
+ * Chunks of file.
+ */
+struct parse_chunks {
+	struct dynarr vals; // Dynamic array of parse_chunk, in order of file
+	int features;
+};
+
+/**
+ * Header of cached record of pre-parsed included file, followed by its lines.
+ */
+struct parse_cache_header {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t hash; // Hash of contents of file
+	uint64_t len; // Length of contents of file
+	uint64_t records_hash; // Hash of records following header, so corrupted records are not loaded
+	uint32_t features; // Enabled assembly language features when file was pre-parsed
+	uint32_t lines_len; // Number of lines within file
+	uint32_t records_len; // Number of records of pre-parsed lines following header
+	uint32_t reserved;
+};
+
+/**
+ * Cached record of line pre-parsed within included file, its trimmed line stored as a range of the file contents.
+ */
+struct parse_cache_line {
+	uint32_t line_num;
+	uint32_t offset;
+	uint32_t len;
+	uint16_t val;
+	uint16_t type;
+};
+
+/**
+ * State of parsed file, shared by the assembly file and all files it includes.
+ */
+struct parse_state {
+	struct parsed_file* file;
+	enum parsed_scope scope;
+	struct parsed_base* result_scope; // Parsed assembly of scope
+	struct dynarr* defs_macros; // Macro definitions allowed within scope, NULL if not allowed
+	struct keymap* defs_macros_map; // Key map of defs_macros, NULL if not allowed
+	struct dynarr line_toks; // Dynamic array of str_view, reused to store tokens of each line
+	struct dynarr includes; // Dynamic array of size_t, offset of path within file->sources_paths of each source file being parsed
+	size_t line_num; // Number of line being parsed, numbered across all source files
+	int features;
+	const struct parse_stream* stream; // Stream to pass lines of root/file scope to, NULL if lines are stored
+	size_t stream_insts; // Number of instructions of root/file scope passed to stream
+	bool stream_ref_macro; // Whether a macro reference was parsed within root/file scope while streaming
+	const struct parse_watch* watch; // Watcher to notify before reading included files, NULL if not watching files
+	const struct parse_cache* cache; // Cache of pre-parsed included files, NULL if included files are pre-parsed each time
+};
+
 static int is_uscore(int ch) { return ch == '_'; }
 
 long parse_number(const char* tok, const size_t len)
 {
-	if (len < 1)
+	// Invalid - empty, or too long to copy
+	if (len < 1 || len > NUM_LEN_MAX)
 		return -1;
 
 	size_t value_ind = 0;
@@ -54,21 +159,18 @@ long parse_number(const char* tok, const size_t len)
 		}
 	}
 
-	const char* tok_in;
-	char tok_fmt[STR_CHARS(len)];
+	char tok_fmt[STR_CHARS(NUM_LEN_MAX)];
 
-	// Format prefixed numbers without prefix and underscores
+	// Copy number to null-terminated string - format prefixed numbers without prefix and underscores
 	if (value_ind > 0) {
-		if (!str_rm(tok_fmt, &tok[value_ind], len, is_uscore))
+		if (!str_rm(tok_fmt, &tok[value_ind], len - value_ind, is_uscore))
 			return -1;
-
-		tok_in = tok_fmt;
-	} else {
-		tok_in = tok;
+	} else if (!str_copy(tok_fmt, tok, len)) {
+		return -1;
 	}
 
 	char* tok_end_ptr = NULL;
-	long result = strtol(tok_in, &tok_end_ptr, value_base);
+	long result = strtol(tok_fmt, &tok_end_ptr, value_base);
 
 	// Invalid
 	if (*tok_end_ptr)
@@ -90,8 +192,8 @@ long parse_number(const char* tok, const size_t len)
  */
 static bool key_valid(const char* tok, const size_t len)
 {
-	// Handle NULL pointer
-	if (!tok)
+	// Handle NULL pointer or empty token
+	if (!tok || len == 0)
 		return false;
 
 	// Key must begin with alpha char (A-Z, a-z), or period (.)
@@ -107,52 +209,23 @@ static bool key_valid(const char* tok, const size_t len)
 		return false;
 
 	// Key must only consist of alpha chars (A-Z, a-z), digit chars (0-9), underscores (_), and periods (.)
-	for (size_t ind = 1; ind < len; ind++) {
-		if (!isalnum(tok[ind]) && tok[ind] != '_' && tok[ind] != '.')
-			return false;
-	}
-
-	return true;
-}
-
-/**
- * Get index of key in dynamic array.
- *
- * @param key Key to search for.
- * @param da Dynamic array to search.
- * @returns Index of key in dynamic array. -1 if not found.
- */
-static long long keys_get(const char* key, const struct dynarr da)
-{
-	if (!key)
-		return false;
-
-	for (size_t ind = 0; ind < da.len; ind++) {
-		char* val = dynarr_get(da, ind);
-		if (!val)
-			continue;
-
-		if (PARSED_KEYS_EQ(val, key))
-			return (long long)ind;
-	}
-
-	return -1;
+	return str_span_ident(&tok[1], len - 1) == len - 1;
 }
 
 /**
  * Push parsed line.
  *
  * @param err Struct to store error.
- * @param lines Dynamic array to store parsed result.
+ * @param lines Parsed lines to store parsed result.
  * @param type Type of parsed line.
  * @param line_num Number of line in file.
  * @param val Parsed line value.
  * @returns Whether parsed line was pushed successfully.
  */
-static bool lines_push(struct error* err, struct dynarr* lines, const enum parsed_line_type type, const size_t line_num, const size_t val)
+static bool lines_push(struct error* err, struct parsed_lines* lines, const enum parsed_line_type type, const size_t line_num, const size_t val)
 {
 	struct parsed_line result = { .type = type, .line_num = line_num, .val = val };
-	if (!dynarr_push(lines, &result, sizeof(result))) {
+	if (!parsed_lines_push(lines, result)) {
 		error_init(err, ERRVAL_FAILURE, "Failed to push parsed line");
 		return false;
 	}
@@ -165,25 +238,54 @@ static bool lines_push(struct error* err, struct dynarr* lines, const enum parse
  *
  * @param err Struct to store error.
  * @param refs_data Dynamic array to store parsed result.
- * @param key Parsed data key.
- * @param key_size Size of parsed data key.
+ * @param refs_data_map Key map of dynamic array to store parsed result.
+ * @param key Interned data key.
  * @returns Index parsed result is located at in dynamic array. -1 if error occurred.
  */
-static long long refs_data_push(struct error* err, struct dynarr* refs_data, const char* key, const size_t key_size)
+static long long refs_data_push(struct error* err, struct dynarr* refs_data, struct keymap* refs_data_map, const symbol_t key)
 {
 	// Find if key already exists in data references array
-	long long existing_ind = keys_get(key, *refs_data);
+	long long existing_ind = keymap_get(*refs_data_map, key);
 	if (existing_ind >= 0)
 		return existing_ind;
 
-	if (!dynarr_push(refs_data, key, key_size)) {
+	if (!dynarr_symbol_push(refs_data, key)) {
 		error_init(err, ERRVAL_FAILURE, "Failed to push parsed data reference");
 		return -1;
 	}
 
+	if (!keymap_push(refs_data_map, key, refs_data->len - 1)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to index parsed data reference");
+		return -1;
+	}
+
 	return (long long)refs_data->len - 1;
 }
 
+/**
+ * Push parsed data definition.
+ *
+ * @param err Struct to store error.
+ * @param defs_data Dynamic array to store parsed result.
+ * @param defs_data_map Key map of dynamic array to store parsed result.
+ * @param def_data Parsed data definition.
+ * @returns Whether parsed data definition was pushed successfully.
+ */
+static bool defs_data_push(struct error* err, struct dynarr* defs_data, struct keymap* defs_data_map, const struct parsed_def_data* def_data)
+{
+	if (!dynarr_parsed_def_data_push(defs_data, *def_data)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push parsed data definition");
+		return false;
+	}
+
+	if (!keymap_push(defs_data_map, def_data->key, defs_data->len - 1)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to index parsed data definition");
+		return false;
+	}
+
+	return true;
+}
+
 /**
  * Push parsed macro parameter reference.
  *
@@ -196,7 +298,7 @@ static long long refs_data_push(struct error* err, struct dynarr* refs_data, con
 static bool refs_macro_params_push(struct error* err, struct dynarr* refs_macro_params, const enum parsed_ref_macro_param_type type, const size_t val)
 {
 	struct parsed_ref_macro_param result = { .type = type, .val = val };
-	if (!dynarr_push(refs_macro_params, &result, sizeof(result))) {
+	if (!dynarr_parsed_ref_macro_param_push(refs_macro_params, result)) {
 		error_init(err, ERRVAL_FAILURE, "Failed to push parsed macro parameter reference");
 		return false;
 	}
@@ -208,13 +310,14 @@ static bool refs_macro_params_push(struct error* err, struct dynarr* refs_macro_
  * Parse key.
  *
  * @param err Struct to store error.
- * @param key String to copy key result to.
+ * @param syms Symbol pool to intern key within.
+ * @param key Symbol to store interned key result.
  * @param tok Token to parse.
- * @param tok_len Length of token to parse.
+ * @param key_len Length of token to parse as key.
  * @param msg Error message suffix.
  * @returns Whether key was valid and parsed successfully.
  */
-static bool parse_key(struct error* err, char* key, const char* tok, const size_t tok_len, const char* msg)
+static bool parse_key(struct error* err, struct symbols* syms, symbol_t* key, const struct str_view* tok, const size_t key_len, const char* msg)
 {
 	// Validate token exists
 	if (!tok) {
@@ -223,32 +326,56 @@ static bool parse_key(struct error* err, char* key, const char* tok, const size_
 	}
 
 	// Validate token can be a key
-	if (!key_valid(tok, tok_len)) {
-		error_init(err, ERRVAL_SYNTAX, "Invalid key given in %s: '%s'", msg, tok);
+	if (!key_valid(tok->str, key_len)) {
+		error_init(err, ERRVAL_SYNTAX, "Invalid key given in %s: '" STR_VIEW_FMT "'", msg, STR_VIEW_ARG(*tok));
 		return false;
 	}
 
-	assert(tok_len <= PARSED_KEY_LEN_MAX);
+	assert(key_len <= PARSED_KEY_LEN_MAX);
 
-	// Copy token to key result
-	if (!str_copy(key, tok, tok_len)) {
-		error_init(err, ERRVAL_FAILURE, "Failed to copy string");
+	// Intern token as key result
+	if (!symbols_intern(syms, key, tok->str, key_len)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to intern key");
 		return false;
 	}
 
 	return true;
 }
 
+/**
+ * Init error of key conflicting with key first used on another line.
+ * Source file of other line is only given if it differs from source file of line being parsed.
+ *
+ * @param err Struct to store error.
+ * @param file Parsed file.
+ * @param line_num Number of line being parsed.
+ * @param line_num_first Number of line key was first used on.
+ * @param tok Token of conflicting key.
+ * @param msg Error message suffix.
+ */
+static void error_conflict(struct error* err, const struct parsed_file* file, const size_t line_num, const size_t line_num_first, const struct str_view* tok, const char* msg)
+{
+	struct parsed_loc loc = parsed_file_loc(*file, line_num);
+	struct parsed_loc loc_first = parsed_file_loc(*file, line_num_first);
+
+	if (!loc.path || !loc_first.path || strcmp(loc.path, loc_first.path) == 0)
+		error_init(err, ERRVAL_SYNTAX, "Conflicting key given in %s, first used on line %zu: '" STR_VIEW_FMT "'", msg, loc_first.line_num, STR_VIEW_ARG(*tok));
+	else
+		error_init(err, ERRVAL_SYNTAX, "Conflicting key given in %s, first used on line %zu of '%s': '" STR_VIEW_FMT "'", msg, loc_first.line_num, loc_first.path, STR_VIEW_ARG(*tok));
+}
+
 /**
  * Parse DEFINE statement.
  *
  * @param err Struct to store error.
+ * @param file Parsed file, to intern keys within.
  * @param defs_data Dynamic array to push parsed result to.
+ * @param defs_data_map Key map of dynamic array to push parsed result to.
  * @param line_num Number of line in file.
  * @param line_toks Dynamic array of tokens in file line.
  * @returns Whether DEFINE statement was valid and parsed successfully.
  */
-static bool parse_def_data_define(struct error* err, struct dynarr* defs_data, const size_t line_num, const struct dynarr line_toks)
+static bool parse_def_data_define(struct error* err, struct parsed_file* file, struct dynarr* defs_data, struct keymap* defs_data_map, const size_t line_num, const struct dynarr line_toks)
 {
 	#define TOKS_DEFINE_LEN 3
 
@@ -258,8 +385,8 @@ static bool parse_def_data_define(struct error* err, struct dynarr* defs_data, c
 
 	// Parse one token at a time
 	for (size_t tok_ind = 0; tok_ind <= TOKS_DEFINE_LEN; tok_ind++) {
-		char* tok = dynarr_get(line_toks, tok_ind);
-		size_t tok_len = (tok) ? strlen(tok) : 0;
+		struct str_view* tok = dynarr_str_view_get(&line_toks, tok_ind);
+		size_t tok_len = (tok) ? tok->len : 0;
 
 		switch (tok_ind) {
 			// DEFINE keyword - verified outside this function
@@ -269,13 +396,13 @@ static bool parse_def_data_define(struct error* err, struct dynarr* defs_data, c
 			// Key
 			case 1:
 				// Validate key
-				if (!parse_key(err, result.key, tok, tok_len, "DEFINE statement"))
+				if (!parse_key(err, &file->syms, &result.key, tok, tok_len, "DEFINE statement"))
 					return false;
 
 				// Validate no data definition with same key already exists
-				struct parsed_def_data* conflict = parsed_def_data_get(*defs_data, result.key);
+				struct parsed_def_data* conflict = parsed_def_data_get(*defs_data, *defs_data_map, result.key);
 				if (conflict) {
-					error_init(err, ERRVAL_SYNTAX, "Conflicting key given in DEFINE statement, first used on line %zu: '%s'", conflict->line_num, tok);
+					error_conflict(err, file, line_num, conflict->line_num, tok, "DEFINE statement");
 					return false;
 				}
 
@@ -290,9 +417,9 @@ static bool parse_def_data_define(struct error* err, struct dynarr* defs_data, c
 				}
 
 				// Parse + set token as number
-				long parsed_number = parse_number(tok, tok_len);
+				long parsed_number = parse_number(tok->str, tok_len);
 				if (parsed_number < 0) {
-					error_init(err, ERRVAL_SYNTAX, "Invalid value given in DEFINE statement: '%s'", tok);
+					error_init(err, ERRVAL_SYNTAX, "Invalid value given in DEFINE statement: '" STR_VIEW_FMT "'", STR_VIEW_ARG(*tok));
 					return false;
 				}
 
@@ -302,7 +429,7 @@ static bool parse_def_data_define(struct error* err, struct dynarr* defs_data, c
 			// Invalid extraneous token
 			default:
 				if (tok) {
-					error_init(err, ERRVAL_SYNTAX, "Invalid value given in DEFINE statement: '%s'", tok);
+					error_init(err, ERRVAL_SYNTAX, "Invalid value given in DEFINE statement: '" STR_VIEW_FMT "'", STR_VIEW_ARG(*tok));
 					return false;
 				}
 
@@ -311,25 +438,22 @@ static bool parse_def_data_define(struct error* err, struct dynarr* defs_data, c
 	}
 
 	// Push parsed result
-	if (!dynarr_push(defs_data, &result, sizeof(result))) {
-		error_init(err, ERRVAL_FAILURE, "Failed to push parsed data definition");
-		return false;
-	}
-
-	return true;
+	return defs_data_push(err, defs_data, defs_data_map, &result);
 }
 
 /**
  * Parse LABEL statement.
  *
  * @param err Struct to store error.
+ * @param file Parsed file, to intern keys within.
  * @param defs_data Dynamic array to push parsed result to.
+ * @param defs_data_map Key map of dynamic array to push parsed result to.
  * @param line_num Number of line in file.
  * @param line_toks Dynamic array of tokens in file line.
  * @param inst_num Number of instructions parsed.
  * @returns Whether LABEL statement was valid and parsed successfully.
  */
-static bool parse_def_data_label(struct error* err, struct dynarr* defs_data, const size_t line_num, const struct dynarr line_toks, const size_t inst_num)
+static bool parse_def_data_label(struct error* err, struct parsed_file* file, struct dynarr* defs_data, struct keymap* defs_data_map, const size_t line_num, const struct dynarr line_toks, const size_t inst_num)
 {
 	#define TOKS_LABEL_LEN 2
 
@@ -337,8 +461,8 @@ static bool parse_def_data_label(struct error* err, struct dynarr* defs_data, co
 	bool colon = false;
 
 	for (size_t tok_ind = 0; tok_ind <= TOKS_LABEL_LEN; tok_ind++) {
-		char* tok = dynarr_get(line_toks, tok_ind);
-		size_t tok_len = (tok) ? strlen(tok) : 0;
+		struct str_view* tok = dynarr_str_view_get(&line_toks, tok_ind);
+		size_t tok_len = (tok) ? tok->len : 0;
 
 		switch (tok_ind) {
 			// LABEL keyword - verified outside this function
@@ -348,19 +472,19 @@ static bool parse_def_data_label(struct error* err, struct dynarr* defs_data, co
 			// Key
 			case 1:
 				// Valid extraneous colon char
-				if (!colon && tok_len > 1 && tok[tok_len - 1] == ':') {
+				if (!colon && tok_len > 1 && tok->str[tok_len - 1] == ':') {
 					colon = true;
 					tok_len--;
 				}
 
 				// Validate key
-				if (!parse_key(err, result.key, tok, tok_len, "LABEL statement"))
+				if (!parse_key(err, &file->syms, &result.key, tok, tok_len, "LABEL statement"))
 					return false;
 
 				// Validate no data definition with same key already exists
-				struct parsed_def_data* conflict = parsed_def_data_get(*defs_data, result.key);
+				struct parsed_def_data* conflict = parsed_def_data_get(*defs_data, *defs_data_map, result.key);
 				if (conflict) {
-					error_init(err, ERRVAL_SYNTAX, "Conflicting key given in LABEL statement, first used on line %zu: '%s'", conflict->line_num, tok);
+					error_conflict(err, file, line_num, conflict->line_num, tok, "LABEL statement");
 					return false;
 				}
 
@@ -368,7 +492,7 @@ static bool parse_def_data_label(struct error* err, struct dynarr* defs_data, co
 
 			case 2:
 				// Valid extraneous colon char
-				if (!colon && tok_len == 1 && tok[0] == ':') {
+				if (!colon && tok_len == 1 && tok->str[0] == ':') {
 					colon = true;
 					break;
 				}
@@ -378,7 +502,7 @@ static bool parse_def_data_label(struct error* err, struct dynarr* defs_data, co
 			// Invalid extraneous token
 			default:
 				if (tok) {
-					error_init(err, ERRVAL_SYNTAX, "Invalid value given in LABEL statement: '%s'", tok);
+					error_init(err, ERRVAL_SYNTAX, "Invalid value given in LABEL statement: '" STR_VIEW_FMT "'", STR_VIEW_ARG(*tok));
 					return false;
 				}
 
@@ -387,36 +511,35 @@ static bool parse_def_data_label(struct error* err, struct dynarr* defs_data, co
 	}
 
 	// Push parsed result
-	if (!dynarr_push(defs_data, &result, sizeof(result))) {
-		error_init(err, ERRVAL_FAILURE, "Failed to push parsed data definition");
-		return false;
-	}
-
-	return true;
+	return defs_data_push(err, defs_data, defs_data_map, &result);
 }
 
 /**
  * Parse %MACRO statement.
  *
  * @param err Struct to store error.
+ * @param file Parsed file, to intern keys within.
  * @param defs_macros Dynamic array to push parsed result to.
+ * @param defs_macros_map Key map of dynamic array to push parsed result to.
  * @param line_num Number of line in file.
  * @param line_toks Dynamic array of tokens in file line.
  * @param features Enabled assembly language features.
  * @returns Whether %MACRO statement was valid and parsed successfully.
  */
-static bool parse_def_macro(struct error* err, struct dynarr* defs_macros, const size_t line_num, const struct dynarr line_toks, const int features)
+static bool parse_def_macro(struct error* err, struct parsed_file* file, struct dynarr* defs_macros, struct keymap* defs_macros_map, const size_t line_num, const struct dynarr line_toks, const int features)
 {
 	#define TOKS_DEF_MACRO_MIN 2
 
 	assert(defs_macros);
+	assert(defs_macros_map);
 
+	// Macro definition allocated from same arena as parsed file
 	struct parsed_def_macro result = { .line_num = line_num };
-	parsed_def_macro_alloc(&result);
+	parsed_def_macro_alloc(&result, defs_macros->arena);
 
 	for (size_t tok_ind = 0; tok_ind < line_toks.len || tok_ind < TOKS_DEF_MACRO_MIN; tok_ind++) {
-		char* tok = dynarr_get(line_toks, tok_ind);
-		size_t tok_len = (tok) ? strlen(tok) : 0;
+		struct str_view* tok = dynarr_str_view_get(&line_toks, tok_ind);
+		size_t tok_len = (tok) ? tok->len : 0;
 
 		switch (tok_ind) {
 			// %MACRO keyword - verified outside this function
@@ -426,13 +549,13 @@ static bool parse_def_macro(struct error* err, struct dynarr* defs_macros, const
 			// Key
 			case 1:
 				// Validate key
-				if (!parse_key(err, result.key, tok, tok_len, "%MACRO statement"))
+				if (!parse_key(err, &file->syms, &result.key, tok, tok_len, "%MACRO statement"))
 					goto error;
 
 				// Validate no macro definition with same key already exists
-				struct parsed_def_macro* conflict = parsed_def_macro_get(*defs_macros, result.key);
+				struct parsed_def_macro* conflict = parsed_def_macro_get(*defs_macros, *defs_macros_map, result.key);
 				if (conflict) {
-					error_init(err, ERRVAL_SYNTAX, "Conflicting key given in %%MACRO statement, first used on line %zu: '%s'", conflict->line_num, tok);
+					error_conflict(err, file, line_num, conflict->line_num, tok, "%MACRO statement");
 					goto error;
 				}
 
@@ -441,36 +564,47 @@ static bool parse_def_macro(struct error* err, struct dynarr* defs_macros, const
 			// Parameters
 			default:
 				if (!(features & LANG_FEAT_DEF_MACRO_PARAMS)) {
-					error_init(err, ERRVAL_SYNTAX, "Invalid value given in %MACRO statement: '%s'", tok);
+					error_init(err, ERRVAL_SYNTAX, "Invalid value given in %%MACRO statement: '" STR_VIEW_FMT "'", STR_VIEW_ARG(*tok));
 					goto error;
 				}
 
-				char param_key[PARSED_KEY_CHARS] = { 0 };
-				if (!parse_key(err, param_key, tok, tok_len, "%MACRO statement"))
+				symbol_t param_key;
+				if (!parse_key(err, &file->syms, &param_key, tok, tok_len, "%MACRO statement"))
 					goto error;
 
 				// Validate parameter key does not already exist
-				if (keys_get(param_key, result.params) >= 0) {
-					error_init(err, ERRVAL_SYNTAX, "Conflicting parameter keys given in %%MACRO statement: '%s'", tok);
+				if (keymap_get(result.params_map, param_key) >= 0) {
+					error_init(err, ERRVAL_SYNTAX, "Conflicting parameter keys given in %%MACRO statement: '" STR_VIEW_FMT "'", STR_VIEW_ARG(*tok));
 					goto error;
 				}
 
 				// Push macro parameter to array
-				if (!dynarr_push(&result.params, param_key, sizeof(param_key))) {
+				if (!dynarr_symbol_push(&result.params, param_key)) {
 					error_init(err, ERRVAL_FAILURE, "Failed to push parsed macro parameter definition");
 					goto error;
 				}
 
+				if (!keymap_push(&result.params_map, param_key, result.params.len - 1)) {
+					error_init(err, ERRVAL_FAILURE, "Failed to index parsed macro parameter definition");
+					goto error;
+				}
+
 				break;
 		}
 	}
 
 	// Push parsed result to array
-	if (!dynarr_push(defs_macros, &result, sizeof(result))) {
+	if (!dynarr_parsed_def_macro_push(defs_macros, result)) {
 		error_init(err, ERRVAL_FAILURE, "Failed to push parsed macro definition");
 		goto error;
 	}
 
+	// Parsed result now owned by array - not freed if indexing fails
+	if (!keymap_push(defs_macros_map, result.key, defs_macros->len - 1)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to index parsed macro definition");
+		return false;
+	}
+
 	return true;
 
 	error:
@@ -482,15 +616,17 @@ static bool parse_def_macro(struct error* err, struct dynarr* defs_macros, const
  * Parse macro reference.
  *
  * @param err Struct to store error.
- * @param lines Dynamic array to push parsed result to.
+ * @param syms Symbol pool to intern keys within.
+ * @param lines Parsed lines to push parsed result to.
  * @param refs_data Dynamic array to push parsed result to.
+ * @param refs_data_map Key map of dynamic array to push parsed result to.
  * @param refs_macros Dynamic array to push parsed result to.
  * @param line_num Number of line in file.
  * @param line_toks Dynamic array of tokens in file line.
  * @param features Enabled assembly language features.
  * @returns Whether macro reference was valid and parsed successfully.
  */
-static bool parse_ref_macro(struct error* err, struct dynarr* lines, struct dynarr* refs_data, struct dynarr* refs_macros, const size_t line_num, const struct dynarr line_toks, const int features)
+static bool parse_ref_macro(struct error* err, struct symbols* syms, struct parsed_lines* lines, struct dynarr* refs_data, struct keymap* refs_data_map, struct dynarr* refs_macros, const size_t line_num, const struct dynarr line_toks, const int features)
 {
 	#define TOKS_REF_MACRO_MIN 1
 
@@ -498,16 +634,17 @@ static bool parse_ref_macro(struct error* err, struct dynarr* lines, struct dyna
 	assert(refs_data);
 	assert(refs_macros);
 
-	struct parsed_ref_macro result = { 0 };
+	// Macro reference allocated from same arena as parsed file
+	struct parsed_ref_macro result = { .params = { .arena = refs_macros->arena } };
 
 	for (size_t tok_ind = 0; tok_ind < line_toks.len || tok_ind < TOKS_REF_MACRO_MIN; tok_ind++) {
-		char* tok = dynarr_get(line_toks, tok_ind);
-		size_t tok_len = (tok) ? strlen(tok) : 0;
+		struct str_view* tok = dynarr_str_view_get(&line_toks, tok_ind);
+		size_t tok_len = (tok) ? tok->len : 0;
 
 		switch (tok_ind) {
 			// Key
 			case 0:
-				if (!parse_key(err, result.key, tok, tok_len, "macro reference"))
+				if (!parse_key(err, syms, &result.key, tok, tok_len, "macro reference"))
 					goto error;
 
 				break;
@@ -515,14 +652,14 @@ static bool parse_ref_macro(struct error* err, struct dynarr* lines, struct dyna
 			// Parameters
 			default:
 				if (!(features & LANG_FEAT_DEF_MACRO_PARAMS)) {
-					error_init(err, ERRVAL_SYNTAX, "Invalid value given in macro reference: '%s'", tok);
+					error_init(err, ERRVAL_SYNTAX, "Invalid value given in macro reference: '" STR_VIEW_FMT "'", STR_VIEW_ARG(*tok));
 					goto error;
 				}
 
 				// Parameter cannot be a data reference
-				if (!(features & LANG_FEAT_DEF_DATA) || !key_valid(tok, tok_len)) {
+				if (!(features & LANG_FEAT_DEF_DATA) || !key_valid(tok->str, tok_len)) {
 					// Try parse parameter as number
-					long parsed_number = parse_number(tok, tok_len);
+					long parsed_number = parse_number(tok->str, tok_len);
 					if (parsed_number >= 0) {
 						if (!refs_macro_params_push(err, &result.params, PARAM_CONST_E, (size_t)parsed_number))
 							goto error;
@@ -531,17 +668,17 @@ static bool parse_ref_macro(struct error* err, struct dynarr* lines, struct dyna
 					}
 
 					// Parameter is invalid
-					error_init(err, ERRVAL_SYNTAX, "Invalid macro parameter value: '%s'", tok);
+					error_init(err, ERRVAL_SYNTAX, "Invalid macro parameter value: '" STR_VIEW_FMT "'", STR_VIEW_ARG(*tok));
 					goto error;
 				}
 
 				// Parse parameter as data reference
-				char ref_data_key[PARSED_KEY_CHARS] = { 0 };
-				if (!parse_key(err, ref_data_key, tok, tok_len, "macro reference"))
+				symbol_t ref_data_key;
+				if (!parse_key(err, syms, &ref_data_key, tok, tok_len, "macro reference"))
 					goto error;
 
 				// Push data reference result
-				long long ref_data_ind = refs_data_push(err, refs_data, ref_data_key, sizeof(ref_data_key));
+				long long ref_data_ind = refs_data_push(err, refs_data, refs_data_map, ref_data_key);
 				if (ref_data_ind < 0)
 					goto error;
 
@@ -554,7 +691,7 @@ static bool parse_ref_macro(struct error* err, struct dynarr* lines, struct dyna
 	}
 
 	// Push macro reference result
-	if (!dynarr_push(refs_macros, &result, sizeof(result))) {
+	if (!dynarr_parsed_ref_macro_push(refs_macros, result)) {
 		error_init(err, ERRVAL_FAILURE, "Failed to push parsed macro reference");
 		goto error;
 	}
@@ -572,53 +709,45 @@ static bool parse_ref_macro(struct error* err, struct dynarr* lines, struct dyna
 }
 
 /**
- * Parse single target of ALU instruction assembly.
+ * Decode token using generated token table.
  *
- * @param tok Token to parse.
- * @returns NGC ALU instruction bit indicating target. -1 if error.
+ * @param tok Token packed using str_ull_to() or str_ull_rm().
+ * @returns Decoded token. Token with all values -1 if not found.
  */
-static long parse_inst_alu_target(const char* tok)
+static const struct token_info* token_get(const unsigned long long tok)
 {
-	switch (str_ull(tok)) {
-		case 0x0041: // A
-			return NGC_IN_TARGET_A;
-		case 0x0044: // D
-			return NGC_IN_TARGET_D;
-		case 0x2A41: // *A
-			return NGC_IN_TARGET_AA;
-		default: // Invalid target
-			return -1;
-	}
+	static const struct token_info token_none = { .key = 0, .inst = -1, .opr = -1, .target = -1, .jump = -1, .directive = DIRECTIVE_NONE_E };
+
+	const struct token_info* token = &tokens_table[TOKENS_HASH(tok, TOKENS_TABLE_MULT, TOKENS_TABLE_SHIFT)];
+	return (token->key == tok) ? token : &token_none;
 }
 
 /**
  * Parse targets of ALU instruction assembly.
  *
- * @param tok Token to parse.
- * @param len Length of token to parse.
+ * @param tok Token to parse, whitespace is ignored.
  * @returns NGC ALU instruction bits indicating targets (bits 4-6). -1 if error.
  */
-static long parse_inst_alu_targets(const char* tok, const size_t len)
+static long parse_inst_alu_targets(const struct str_view tok)
 {
-	// Invalid - null input
-	if (!tok)
-		return -1;
-
-	#define TOK_TARGET_SEP ","
-	#define TOK_TARGET_SEP_LEN strlen(TOK_TARGET_SEP)
+	#define TOK_TARGET_SEP ','
 
-	char tok_copy[STR_CHARS(len)];
-	if (!str_copy(tok_copy, tok, len))
+	// Invalid - null input
+	if (!tok.str)
 		return -1;
 
 	int result = 0;
-	size_t parsed_len = 0;
-	char* target = strtok(tok_copy, TOK_TARGET_SEP);
+	const char* target = tok.str;
+	const char* tok_end = tok.str + tok.len;
 
-	while (target) {
-		int target_parsed = parse_inst_alu_target(target);
+	for (;;) {
+		// Get end of target - next separator or end of token
+		const char* target_end = memchr(target, TOK_TARGET_SEP, (size_t)(tok_end - target));
+		if (!target_end)
+			target_end = tok_end;
 
-		// Invalid target
+		// Invalid target, including empty targets from extraneous separators
+		long target_parsed = token_get(str_ull_rm(target, (size_t)(target_end - target), isspace))->target;
 		if (target_parsed < 0)
 			return -1;
 
@@ -626,158 +755,46 @@ static long parse_inst_alu_targets(const char* tok, const size_t len)
 		if (target_parsed & result)
 			return -1;
 
-		parsed_len += strlen(target);
 		result |= target_parsed;
 
-		target = strtok(NULL, TOK_TARGET_SEP);
-		if (target)
-			parsed_len += TOK_TARGET_SEP_LEN;
-	}
-
-	// Invalid - extraneous separator
-	if (parsed_len < len)
-		return -1;
-
-	return result;
-}
+		if (target_end == tok_end)
+			break;
 
-/**
- * Parse operation of ALU instruction assembly.
- *
- * @param tok Token to parse.
- * @returns NGC ALU instruction bits indicating operation (bits 7-13). -1 if error.
- */
-static long parse_inst_alu_opr(const char* tok)
-{
-	switch (str_ull(tok)) {
-		case 0x00000030: // 0
-			return NGC_IN_OPR_ZX;
-		case 0x00000031: // 1
-			return NGC_IN_OPR_U | NGC_IN_OPR_OP0 | NGC_IN_OPR_ZX;
-		case 0x00002D31: // -1
-			return NGC_IN_OPR_NEG1;
-		case 0x00000041: // A
-			return NGC_IN_OPR_U | NGC_IN_OPR_ZX;
-		case 0x00002D41: // -A
-			return NGC_IN_OPR_U | NGC_IN_OPR_OP1 | NGC_IN_OPR_ZX;
-		case 0x00007E41: // ~A
-			return NGC_IN_OPR_OP1 | NGC_IN_OPR_OP0 | NGC_IN_OPR_SW;
-		case 0x00412B31: // A+1
-			return NGC_IN_OPR_U | NGC_IN_OPR_OP0 | NGC_IN_OPR_SW;
-		case 0x00412D31: // A-1
-			return NGC_IN_OPR_U | NGC_IN_OPR_OP1 | NGC_IN_OPR_OP0 | NGC_IN_OPR_SW;
-		case 0x00412D44: // A-D
-			return NGC_IN_OPR_U | NGC_IN_OPR_OP1 | NGC_IN_OPR_SW;
-		case 0x00000044: // D
-			return NGC_IN_OPR_U | NGC_IN_OPR_ZX | NGC_IN_OPR_SW;
-		case 0x00002D44: // -D
-			return NGC_IN_OPR_U | NGC_IN_OPR_OP1 | NGC_IN_OPR_ZX | NGC_IN_OPR_SW;
-		case 0x00007E44: // ~D
-			return NGC_IN_OPR_OP1 | NGC_IN_OPR_OP0;
-		case 0x00442B31: // D+1
-			return NGC_IN_OPR_U | NGC_IN_OPR_OP0;
-		case 0x00442D31: // D-1
-			return NGC_IN_OPR_U | NGC_IN_OPR_OP1 | NGC_IN_OPR_OP0;
-		case 0x00442B41: // D+A
-			return NGC_IN_OPR_U;
-		case 0x442B2A41: // D+*A
-			return NGC_IN_AA | NGC_IN_OPR_U;
-		case 0x00442D41: // D-A
-			return NGC_IN_OPR_U | NGC_IN_OPR_OP1;
-		case 0x442D2A41: // D-*A
-			return NGC_IN_AA | NGC_IN_OPR_U | NGC_IN_OPR_OP1;
-		case 0x00442641: // D&A
-			return 0x00;
-		case 0x44262A41: // D&*A
-			return NGC_IN_AA;
-		case 0x00447C41: // D|A
-			return NGC_IN_OPR_OP0;
-		case 0x447C2A41: // D|*A
-			return NGC_IN_AA | NGC_IN_OPR_OP0;
-		case 0x00445E41: // D^A
-			return NGC_IN_OPR_OP1;
-		case 0x445E2A41: // D^*A
-			return NGC_IN_AA | NGC_IN_OPR_OP1;
-		case 0x00002A41: // *A
-			return NGC_IN_AA | NGC_IN_OPR_U | NGC_IN_OPR_ZX;
-		case 0x002D2A41: // -*A
-			return NGC_IN_AA | NGC_IN_OPR_U | NGC_IN_OPR_OP1 | NGC_IN_OPR_ZX;
-		case 0x007E2A41: // ~*A
-			return NGC_IN_AA | NGC_IN_OPR_OP1 | NGC_IN_OPR_OP0 | NGC_IN_OPR_SW;
-		case 0x2A412B31: // *A+1
-			return NGC_IN_AA | NGC_IN_OPR_U | NGC_IN_OPR_OP0 | NGC_IN_OPR_SW;
-		case 0x2A412D31: // *A-1
-			return NGC_IN_AA | NGC_IN_OPR_U | NGC_IN_OPR_OP1 | NGC_IN_OPR_OP0 | NGC_IN_OPR_SW;
-		case 0x2A412D44: // *A-D
-			return NGC_IN_AA | NGC_IN_OPR_U | NGC_IN_OPR_OP1 | NGC_IN_OPR_SW;
-		default: // Invalid operation
-			return -1;
+		target = target_end + 1;
 	}
-}
 
-/**
- * Parse jump condition of ALU instruction assembly.
- *
- * @param tok Token to parse.
- * @returns NGC ALU instruction bits indicating jump condition (bits 1-3). -1 if error.
- */
-static long parse_inst_alu_jump(const char* tok)
-{
-	switch (str_ull(tok)) {
-		case 0x4A4754: // JGT
-			return NGC_IN_JUMP_GT;
-		case 0x4A4551: // JEQ
-			return NGC_IN_JUMP_EQ;
-		case 0x4A4745: // JGE
-			return NGC_IN_JUMP_EQ | NGC_IN_JUMP_GT;
-		case 0x4A4C54: // JLT
-			return NGC_IN_JUMP_LT;
-		case 0x4A4E45: // JNE
-			return NGC_IN_JUMP_LT | NGC_IN_JUMP_GT;
-		case 0x4A4C45: // JLE
-			return NGC_IN_JUMP_LT | NGC_IN_JUMP_EQ;
-		case 0x4A4D50: // JMP
-			return NGC_IN_JUMP_LT | NGC_IN_JUMP_EQ | NGC_IN_JUMP_GT;
-		default: // Invalid condition
-			return -1;
-	}
+	return result;
 }
 
 /**
  * Parse ALU instruction assembly.
  *
  * @param err Struct to store error.
- * @param lines Dynamic array to push parsed result.
+ * @param lines Parsed lines to push parsed result.
  * @param line_num Number of line in file.
- * @param line_st Assembly line with whitespace stripped.
- * @param line_len Length of assembly line.
+ * @param line_tr Assembly line with leading and trailing whitespace trimmed.
  * @param features Enabled assembly language features.
  * @returns Enum value indicating whether ALU instruction was valid and parsed successfully, or hint if file line could be another kind of instruction.
  */
-static enum parse_inst_alu_result parse_inst_alu(struct error* err, struct dynarr* lines, const size_t line_num, const char* line_st, const size_t line_len, const signed int features)
+static enum parse_inst_alu_result parse_inst_alu(struct error* err, struct parsed_lines* lines, const size_t line_num, const struct str_view line_tr, const signed int features)
 {
-	// Original NandGame assembler sets bits 14-16 of ALU instructions to 1 despite only bit 16 being relevant
-	#define NGC_IN_ALU (NGC_IN_CI | (1 << 14) | (1 << 13))
-
 	assert(lines);
 
-	// Special syntax case - line can be JMP only
-	if (strncmp(line_st, "JMP", line_len) == 0)
-	{
-		// Original NandGame assembler sets operation bits of instruction to "-1"
-		if (!lines_push(err, lines, LINE_INST_E, line_num, (size_t)(NGC_IN_ALU | NGC_IN_OPR_NEG1 | NGC_IN_JUMP_LT | NGC_IN_JUMP_EQ | NGC_IN_JUMP_GT)))
+	// Special syntax case - line can be a single token instruction, e.g. JMP only
+	long inst = token_get(str_ull_rm(line_tr.str, line_tr.len, isspace))->inst;
+	if (inst >= 0) {
+		if (!lines_push(err, lines, LINE_INST_E, line_num, (size_t)inst))
 			return ALU_INST_FAILURE_E;
 
 		return ALU_INST_SUCCESS_E;
 	}
 
 	// Get pointers to ALU instruction token separators
-	char* line_equals_ptr = strchr(line_st, '=');
-	char* line_semicol_ptr = strchr(line_st, ';');
+	const char* line_equals_ptr = memchr(line_tr.str, '=', line_tr.len);
+	const char* line_semicol_ptr = memchr(line_tr.str, ';', line_tr.len);
 
-	// Init ALU operation token ind and len
-	size_t tok_opr_ind = 0;
-	size_t tok_opr_len = 0;
+	// Init ALU operation token - whole line unless separators are found
+	struct str_view tok_opr = line_tr;
 
 	// Init ALU instruction parts
 	long inst_target = 0, inst_opr = 0, inst_jump = 0;
@@ -785,70 +802,52 @@ static enum parse_inst_alu_result parse_inst_alu(struct error* err, struct dynar
 	// Equals char found - syntax expected to be "[Target] = [Operation] [...]"
 	// Parse ALU target
 	if (line_equals_ptr) {
-		tok_opr_ind = (int)(line_equals_ptr - line_st) + 1; // Char after '='
-		int tok_target_len = tok_opr_ind - 1;
+		struct str_view tok_target = { .str = line_tr.str, .len = (size_t)(line_equals_ptr - line_tr.str) };
+		tok_opr.str = line_equals_ptr + 1; // Char after '='
+		tok_opr.len = line_tr.len - tok_target.len - 1;
 
 		// Syntax error - no chars before '='
-		if (tok_target_len < 1) {
+		if (tok_target.len < 1) {
 			error_init(err, ERRVAL_SYNTAX, "No target given");
 			return ALU_INST_FAILURE_E;
 		}
 
-		// Copy target token to new string
-		char tok_target[STR_CHARS(tok_target_len)];
-		if (!str_copy(tok_target, line_st, tok_target_len)) {
-			error_init(err, ERRVAL_FAILURE, "Failed to copy string");
-			return ALU_INST_FAILURE_E;
-		}
-
 		// Parse target
-		inst_target = parse_inst_alu_targets(tok_target, tok_target_len);
+		inst_target = parse_inst_alu_targets(tok_target);
 		if (inst_target < 0) {
-			error_init(err, ERRVAL_SYNTAX, "Invalid target: '%s'", tok_target);
+			char tok_target_st[STR_CHARS(TOK_ERR_LEN_MAX)];
+			error_init(err, ERRVAL_SYNTAX, "Invalid target: '%s'", str_rm(tok_target_st, tok_target.str, TOK_ERR_LEN(tok_target.len), isspace));
 			return ALU_INST_FAILURE_E;
 		}
 	}
 
-	tok_opr_len = line_len - tok_opr_ind;
-
 	// Semicolon char found - syntax expected to be "[...] [Operation] ; [Jump]"
 	// Parse ALU jump condition
 	if (line_semicol_ptr) {
-		int tok_jump_ind = (int)(line_semicol_ptr - line_st) + 1; // Char after ';'
-		int tok_jump_len = line_len - tok_jump_ind;
+		struct str_view tok_jump = { .str = line_semicol_ptr + 1 }; // Char after ';'
+		tok_jump.len = (size_t)(line_tr.str + line_tr.len - tok_jump.str);
 
 		// Syntax error - no chars after ';'
-		if (tok_jump_len < 1) {
+		if (tok_jump.len < 1) {
 			error_init(err, ERRVAL_SYNTAX, "No jump condition given");
 			return ALU_INST_FAILURE_E;
 		}
 
-		tok_opr_len = tok_opr_len - tok_jump_len - 1;
-
-		// Copy jump condition token to new string
-		char tok_jump[STR_CHARS(tok_jump_len)];
-		if (!str_copy(tok_jump, &line_st[tok_jump_ind], tok_jump_len)) {
-			error_init(err, ERRVAL_FAILURE, "Failed to copy string");
-			return ALU_INST_FAILURE_E;
-		}
-
 		// Parse jump condition
-		inst_jump = parse_inst_alu_jump(tok_jump);
+		inst_jump = token_get(str_ull_rm(tok_jump.str, tok_jump.len, isspace))->jump;
 		if (inst_jump < 0) {
-			error_init(err, ERRVAL_SYNTAX, "Invalid jump condition: '%s'", tok_jump);
+			char tok_jump_st[STR_CHARS(TOK_ERR_LEN_MAX)];
+			error_init(err, ERRVAL_SYNTAX, "Invalid jump condition: '%s'", str_rm(tok_jump_st, tok_jump.str, TOK_ERR_LEN(tok_jump.len), isspace));
 			return ALU_INST_FAILURE_E;
 		}
-	}
 
-	// Copy ALU operation token to new string
-	char tok_opr[STR_CHARS(tok_opr_len)];
-	if (!str_copy(tok_opr, &line_st[tok_opr_ind], tok_opr_len)) {
-		error_init(err, ERRVAL_FAILURE, "Failed to copy string");
-		return ALU_INST_FAILURE_E;
+		// Operation ends before ';'
+		tok_opr.len = (tok_opr.str < line_semicol_ptr) ? (size_t)(line_semicol_ptr - tok_opr.str) : 0;
 	}
 
 	// Parse ALU operation
-	inst_opr = parse_inst_alu_opr(tok_opr);
+	const struct token_info* tok_opr_info = token_get(str_ull_rm(tok_opr.str, tok_opr.len, isspace));
+	inst_opr = tok_opr_info->opr;
 	if (inst_opr >= 0) {
 		if (!lines_push(err, lines, LINE_INST_E, line_num, (size_t)(NGC_IN_ALU | inst_opr | inst_target | inst_jump)))
 			return ALU_INST_FAILURE_E;
@@ -857,7 +856,7 @@ static enum parse_inst_alu_result parse_inst_alu(struct error* err, struct dynar
 	}
 
 	// ALU operation invalid - return hint if file line could be another kind of instruction
-	if (!line_semicol_ptr && parse_inst_alu_jump(tok_opr) < 0) {
+	if (!line_semicol_ptr && tok_opr_info->jump < 0) {
 		// Line could be a data instruction - "A = [...]"
 		if (line_equals_ptr && inst_target == NGC_IN_TARGET_A)
 			return ALU_INST_HINT_INST_DATA_E;
@@ -868,7 +867,8 @@ static enum parse_inst_alu_result parse_inst_alu(struct error* err, struct dynar
 	}
 
 	// ALU operation invalid
-	error_init(err, ERRVAL_SYNTAX, "Invalid operation: '%s'", tok_opr);
+	char tok_opr_st[STR_CHARS(TOK_ERR_LEN_MAX)];
+	error_init(err, ERRVAL_SYNTAX, "Invalid operation: '%s'", str_rm(tok_opr_st, tok_opr.str, TOK_ERR_LEN(tok_opr.len), isspace));
 	return ALU_INST_FAILURE_E;
 }
 
@@ -876,37 +876,33 @@ static enum parse_inst_alu_result parse_inst_alu(struct error* err, struct dynar
  * Parse data instruction.
  *
  * @param err Struct to store error.
- * @param lines Dynamic array to push parsed result.
+ * @param syms Symbol pool to intern keys within.
+ * @param lines Parsed lines to push parsed result.
  * @param refs_data Dynamic array to push parsed result.
+ * @param refs_data_map Key map of dynamic array to push parsed result.
  * @param line_num Number of line in file.
- * @param line_tr Assembly line with whitespace trimmed.
- * @param line_len Length of assembly line.
+ * @param line_tr Assembly line with leading and trailing whitespace trimmed.
  * @param features Enabled assembly language features.
  * @returns Whether data instruction was valid and parsed successfully.
  */
-static bool parse_inst_data(struct error* err, struct dynarr* lines, struct dynarr* refs_data, const size_t line_num, const char* line_tr, const size_t line_len, const signed int features)
+static bool parse_inst_data(struct error* err, struct symbols* syms, struct parsed_lines* lines, struct dynarr* refs_data, struct keymap* refs_data_map, const size_t line_num, const struct str_view line_tr, const signed int features)
 {
 	// Get pointer to '=' char
 	// Whether 'A' is being targeted before '=' is checked before this function
-	char* line_equals_ptr = strchr(line_tr, '=');
+	const char* line_equals_ptr = memchr(line_tr.str, '=', line_tr.len);
 	if (!line_equals_ptr) {
 		error_init(err, ERRVAL_SYNTAX, "Invalid instruction");
 		return false;
 	}
 
 	// Get string after '=' char and trim - use as value for data instruction
-	char data_str[STR_CHARS(line_len)];
-	if (!str_trim(data_str, line_equals_ptr + 1, line_len)) {
-		error_init(err, ERRVAL_FAILURE, "Failed to trim whitespace from string");
-		return false;
-	}
-
-	size_t data_str_len = strlen(data_str);
+	struct str_view data_after_equals = { .str = line_equals_ptr + 1, .len = (size_t)(line_tr.str + line_tr.len - line_equals_ptr - 1) };
+	struct str_view data_str = str_view_trim(data_after_equals);
 
 	// Data value cannot be a data reference key
-	if (!(features & LANG_FEAT_DEF_DATA) || !key_valid(data_str, data_str_len)) {
+	if (!(features & LANG_FEAT_DEF_DATA) || !key_valid(data_str.str, data_str.len)) {
 		// Try parse data value as number
-		long parsed_number = parse_number(data_str, data_str_len);
+		long parsed_number = parse_number(data_str.str, data_str.len);
 		if (parsed_number >= 0) {
 			if (!lines_push(err, lines, LINE_INST_E, line_num, (size_t)parsed_number))
 				return false;
@@ -915,19 +911,19 @@ static bool parse_inst_data(struct error* err, struct dynarr* lines, struct dyna
 		}
 
 		// Data value is invalid
-		error_init(err, ERRVAL_SYNTAX, "Invalid operation: '%s'", data_str);
+		error_init(err, ERRVAL_SYNTAX, "Invalid operation: '" STR_VIEW_FMT "'", STR_VIEW_ARG(data_str));
 		return false;
 	}
 
-	// Ensure key is null-terminated
-	char data_key[PARSED_KEY_CHARS] = { 0 };
-	if (!str_copy(data_key, data_str, data_str_len)) {
-		error_init(err, ERRVAL_FAILURE, "Failed to copy string");
+	// Intern key
+	symbol_t data_key;
+	if (!symbols_intern(syms, &data_key, data_str.str, data_str.len)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to intern key");
 		return false;
 	}
 
 	// Push data reference result
-	long long ref_data_ind = refs_data_push(err, refs_data, data_key, sizeof(data_key));
+	long long ref_data_ind = refs_data_push(err, refs_data, refs_data_map, data_key);
 	if (ref_data_ind < 0)
 		return false;
 
@@ -939,234 +935,872 @@ static bool parse_inst_data(struct error* err, struct dynarr* lines, struct dyna
 }
 
 /**
- * Parse line of assembly file.
+ * Get whether token is the %INCLUDE keyword, compared as uppercase.
+ */
+static bool parse_include_is(const struct str_view tok)
+{
+	return tok.len == strlen(DIRECTIVE_INCLUDE) && str_comp(tok.str, DIRECTIVE_INCLUDE, tok.len, toupper) == 0;
+}
+
+/**
+ * Set destinations of parsed results for scope once line has changed scope.
  *
  * @param err Struct to store error.
- * @param result Struct to store parsed result.
- * @param defs_macros Dynamic array to push parsed result.
- * @param scope Scope assembly line is being parsed within.
- * @param line_num Number of line in file.
- * @param line Assembly line.
- * @param line_len Length of assembly line.
- * @param features Enabled assembly language features.
- * @returns Whether line was valid and parsed successfully.
+ * @param state State of parsed file.
+ * @param scope Scope changed to.
+ * @returns Whether destinations were set successfully.
  */
-static bool parse_line(struct error* err, struct parsed_base* result, struct dynarr* defs_macros, enum parsed_scope* scope, const size_t line_num, const char* line, const size_t line_len, const int features)
+static bool parse_scope_set(struct error* err, struct parse_state* state, const enum parsed_scope scope)
 {
-	assert(result);
-	assert(scope);
+	state->scope = scope;
 
-	bool success = false;
+	switch (scope) {
+		case SCOPE_FILE_E:
+			state->defs_macros = &state->file->defs_macros;
+			state->defs_macros_map = &state->file->defs_macros_map;
+			state->result_scope = &state->file->base;
+			return true;
 
-	char line_tr[STR_CHARS(line_len)];
-	char line_st[STR_CHARS(line_len)];
+		case SCOPE_MACRO_E:
+			state->defs_macros = NULL;
+			state->defs_macros_map = NULL;
 
-	struct dynarr line_toks = { 0 };
+			// Get last macro definition
+			struct parsed_def_macro* def_macro = dynarr_parsed_def_macro_get(&state->file->defs_macros, state->file->defs_macros.len - 1);
+			if (!def_macro) {
+				error_init(err, ERRVAL_FAILURE, "Failed to find macro scope");
+				return false;
+			}
 
-	// Trim whitespace from line
-	if (!str_trim(line_tr, line, line_len)) {
-		error_init(err, ERRVAL_FAILURE, "Failed to trim whitespace from string");
-		goto exit;
+			// Set destination to last macro
+			state->result_scope = &def_macro->base;
+			return true;
+
+		default:
+			error_init(err, ERRVAL_FAILURE, "Unknown result scope: %d", scope);
+			return false;
+	}
+}
+
+/**
+ * Push path of source file to parsed file.
+ *
+ * @param err Struct to store error.
+ * @param file Parsed file.
+ * @param dir Offset of path within sources paths to prefix path with.
+ * @param dir_len Length of prefix of path, 0 if not prefixed.
+ * @param path Path of source file.
+ * @returns Offset of pushed path within sources paths. -1 if error.
+ */
+static long long sources_path_push(struct error* err, struct parsed_file* file, const size_t dir, const size_t dir_len, const struct str_view path)
+{
+	size_t offset = file->sources_paths.len;
+	char nul = '\0';
+
+	// Path is set first, as setting it may move prefix within sources paths
+	if ((path.len > 0 && !dynarr_set(&file->sources_paths, offset + dir_len, path.str, path.len, sizeof(char)))
+	    || (dir_len > 0 && !dynarr_set(&file->sources_paths, offset, dynarr_char_get(&file->sources_paths, dir), dir_len, sizeof(char)))
+	    || !dynarr_char_push(&file->sources_paths, nul)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push path of source file");
+		return -1;
 	}
 
-	size_t line_tr_len = strlen(line_tr);
+	return (long long)offset;
+}
 
-	// Skip line if empty or comment
-	if (line_tr[0] == '#' || line_tr[0] == '\0') {
-		success = true;
-		goto exit;
+/**
+ * Push range of lines read from source file, starting from the next line to parse.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file.
+ * @param path Offset of path of source file within sources paths.
+ * @param line_num_source Number of next line to parse within source file.
+ * @returns Whether range was pushed successfully.
+ */
+static bool sources_push(struct error* err, struct parse_state* state, const size_t path, const size_t line_num_source)
+{
+	struct parsed_source source = { .path = path, .line_num = state->line_num + 1, .line_num_source = line_num_source };
+
+	if (!dynarr_parsed_source_push(&state->file->sources, source)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push source file");
+		return false;
 	}
 
-	if (features > 0) {
-		// Build array of tokens in line
-		if (!str_split(&line_toks, line_tr, line_tr_len, WHITESPACE)) {
-			error_init(err, ERRVAL_FAILURE, "Failed to split string");
-			goto exit;
-		}
+	return true;
+}
 
-		// Copy first token
-		char line_tok_first[STR_CHARS(STRULL_MAX_LEN)] = { 0 };
-		if (!str_copy(line_tok_first, (char*)dynarr_get(line_toks, 0), STRULL_MAX_LEN)) {
-			error_init(err, ERRVAL_FAILURE, "Failed to copy string");
-			goto exit;
+/**
+ * Read whole file to buffer.
+ *
+ * @param path Path of file.
+ * @param len Pointer to store length of file contents.
+ * @returns Allocated contents of file, not null-terminated. NULL if error.
+ */
+static char* file_read(const char* path, size_t* len)
+{
+	char* buf = NULL;
+	size_t capacity = 0;
+	*len = 0;
+
+	FILE* fp = fopen(path, "rb");
+	if (!fp)
+		return NULL;
+
+	for (;;) {
+		// Increase capacity to fit next read
+		if (capacity - *len < INCLUDE_READ_SIZE) {
+			size_t capacity_new = (capacity > 0) ? capacity * 2 : INCLUDE_READ_SIZE;
+			char* buf_new = realloc(buf, capacity_new);
+			if (!buf_new)
+				goto error;
+
+			buf = buf_new;
+			capacity = capacity_new;
 		}
 
-		// Convert first token to uppercase
-		if (!str_to(line_tok_first, line_tok_first, STRULL_MAX_LEN, toupper)) {
-			error_init(err, ERRVAL_FAILURE, "Failed to convert string to uppercase");
-			goto exit;
+		size_t read_len = fread(&buf[*len], sizeof(char), capacity - *len, fp);
+		*len += read_len;
+
+		if (read_len == 0)
+			break;
+	}
+
+	if (ferror(fp))
+		goto error;
+
+	fclose(fp);
+	return buf;
+
+	error:
+	fclose(fp);
+	free(buf);
+	return NULL;
+}
+
+static bool parse_line(struct error* err, struct parse_state* state, const char* line, const size_t line_len);
+static bool parse_buf_cached(struct error* err, struct parse_state* state, const char* buf, const size_t len);
+
+/**
+ * Get length of line up to newline char or end of buffer, ignoring any chars after a null char.
+ *
+ * @param line Start of line.
+ * @param buf_len Length of buffer from start of line.
+ * @param next_ind Index to store start of next line, relative to start of line.
+ * @returns Length of line.
+ */
+static size_t line_len_get(const char* line, const size_t buf_len, size_t* next_ind)
+{
+	const char* line_end = memchr(line, '\n', buf_len);
+	size_t line_len = (line_end) ? (size_t)(line_end - line) : buf_len;
+	*next_ind = line_len + 1;
+
+	// Ignore any chars after a null char
+	const char* line_nul = memchr(line, '\0', line_len);
+	if (line_nul)
+		line_len = (size_t)(line_nul - line);
+
+	return line_len;
+}
+
+/**
+ * Pass stored lines of root/file scope to stream, once enough lines are stored.
+ * Streaming stops if a macro reference is parsed within root/file scope, as macros are expanded from the stored lines of the file.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file.
+ * @param force Whether to pass stored lines regardless of how many are stored.
+ * @returns Whether lines were passed to stream successfully. False without error if a macro reference was parsed.
+ */
+static bool parse_stream_flush(struct error* err, struct parse_state* state, const bool force)
+{
+	struct parsed_base* base = &state->file->base;
+	if (!state->stream || (!force && base->lines.len < STREAM_LINES_LEN))
+		return true;
+
+	if (base->refs_macros.len > 0) {
+		state->stream_ref_macro = true;
+		return false;
+	}
+
+	struct parsed_lines_iter iter = { 0 };
+	for (struct parsed_line line; parsed_lines_next(&base->lines, &iter, &line);) {
+		if (!state->stream->line(state->stream->ctx, err, state->file, line))
+			return false;
+	}
+
+	state->stream_insts += base->lines.len;
+	parsed_lines_clear(&base->lines);
+	return true;
+}
+
+/**
+ * Parse lines of buffer in order.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file, storing number of line associated with error.
+ * @param buf Contents of source file, does not need to be null-terminated.
+ * @param len Length of contents of source file.
+ * @returns Whether all lines were valid and parsed successfully.
+ */
+static bool parse_buf(struct error* err, struct parse_state* state, const char* buf, const size_t len)
+{
+	for (size_t buf_ind = 0, next_ind; buf_ind < len; buf_ind += next_ind) {
+		state->line_num++;
+
+		// Get line up to newline char or end of buffer
+		const char* line = &buf[buf_ind];
+		size_t line_len = line_len_get(line, len - buf_ind, &next_ind);
+
+		if (!parse_line(err, state, line, line_len) || !parse_stream_flush(err, state, false))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Parse %INCLUDE statement, parsing lines of included file in place of statement.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file.
+ * @param line_tr Line of statement with leading and trailing whitespace trimmed.
+ * @param tok_len Length of %INCLUDE keyword token.
+ * @returns Whether %INCLUDE statement and included file were valid and parsed successfully.
+ */
+static bool parse_include(struct error* err, struct parse_state* state, const struct str_view line_tr, const size_t tok_len)
+{
+	struct parsed_file* file = state->file;
+	size_t includes_len = state->includes.len;
+	size_t line_num_include = state->line_num;
+	char* buf = NULL;
+	bool result = false;
+
+	// %INCLUDE statement only allowed in main scope
+	if (state->scope != SCOPE_FILE_E) {
+		error_init(err, ERRVAL_SYNTAX, "%%INCLUDE statement not allowed within macro definition");
+		return false;
+	}
+
+	// Path is the remainder of line, which may contain whitespace
+	struct str_view path = str_view_trim((struct str_view){ .str = &line_tr.str[tok_len], .len = line_tr.len - tok_len });
+	if (path.len == 0) {
+		error_init(err, ERRVAL_SYNTAX, "No path given in %%INCLUDE statement");
+		return false;
+	}
+
+	// Relative path is relative to directory of including file
+	size_t* includer = dynarr_size_get(&state->includes, includes_len - 1);
+	assert(includer);
+	size_t includer_path = *includer;
+	const char* includer_dir_end = strrchr(dynarr_char_get(&file->sources_paths, includer_path), '/');
+	size_t dir_len = (path.str[0] != '/' && includer_dir_end) ? (size_t)(includer_dir_end - dynarr_char_get(&file->sources_paths, includer_path)) + 1 : 0;
+
+	long long include_path = sources_path_push(err, file, includer_path, dir_len, path);
+	if (include_path < 0)
+		return false;
+
+	// Validate file is not already being parsed
+	const char* include_path_str = dynarr_char_get(&file->sources_paths, (size_t)include_path);
+	for (size_t includes_ind = 0; includes_ind < includes_len; includes_ind++) {
+		if (strcmp(dynarr_char_get(&file->sources_paths, *dynarr_size_get(&state->includes, includes_ind)), include_path_str) == 0) {
+			error_init(err, ERRVAL_SYNTAX, "%%INCLUDE statement is recursive: '" STR_VIEW_FMT "'", STR_VIEW_ARG(path));
+			return false;
 		}
+	}
+
+	// Read whole included file, once watcher has stored its state
+	if (state->watch)
+		state->watch->include(state->watch->ctx, include_path_str);
+
+	size_t buf_len;
+	buf = file_read(include_path_str, &buf_len);
+	if (!buf) {
+		error_init(err, ERRVAL_SYNTAX, "Failed to read file given in %%INCLUDE statement: '" STR_VIEW_FMT "'", STR_VIEW_ARG(path));
+		return false;
+	}
+
+	size_t include_path_ind = (size_t)include_path;
+	if (!dynarr_size_push(&state->includes, include_path_ind)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push included file");
+		goto exit;
+	}
+
+	// Parse lines of included file, numbered after line of statement
+	bool parsed = sources_push(err, state, include_path_ind, 1) && ((state->cache) ? parse_buf_cached(err, state, buf, buf_len) : parse_buf(err, state, buf, buf_len));
+	if (!parsed)
+		goto exit;
+
+	// Validate all macro definitions of included file have been ended
+	if (state->scope != SCOPE_FILE_E) {
+		error_init(err, ERRVAL_SYNTAX, "%%MACRO statement must have an accompanying %%END statement");
+		goto exit;
+	}
+
+	// Following lines of including file are numbered after lines of included file
+	result = sources_push(err, state, includer_path, parsed_file_loc(*file, line_num_include).line_num + 1);
+
+	exit:
+	state->includes.len = includes_len;
+	free(buf);
+	return result;
+}
+
+/**
+ * Split line into token views, stored within state to reuse space between lines.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file, storing tokens of line.
+ * @param line_tr Line with leading and trailing whitespace trimmed.
+ * @returns Whether line was split successfully.
+ */
+static bool parse_line_split(struct error* err, struct parse_state* state, const struct str_view line_tr)
+{
+	if (str_view_split(&state->line_toks, line_tr) < 1) {
+		error_init(err, ERRVAL_FAILURE, "Failed to split string");
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Parse line of assembly file.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file, storing scope line is being parsed within and number of line.
+ * @param line Assembly line.
+ * @param line_len Length of assembly line.
+ * @returns Whether line was valid and parsed successfully.
+ */
+static bool parse_line(struct error* err, struct parse_state* state, const char* line, const size_t line_len)
+{
+	assert(state);
+
+	struct parsed_base* result = state->result_scope;
+	struct symbols* syms = &state->file->syms;
+	const size_t line_num = state->line_num;
+	const int features = state->features;
+
+	// Trim whitespace from line
+	struct str_view line_full = { .str = line, .len = line_len };
+	struct str_view line_tr = str_view_trim(line_full);
+
+	// Skip line if empty or comment
+	if (line_tr.len == 0 || line_tr.str[0] == '#')
+		return true;
+
+	if (features > 0) {
+		// Get first token, compared as uppercase
+		// Instructions only need their first token - the whole line is only split into tokens for statements and macro references
+		struct str_view line_tok_first = { .str = line_tr.str, .len = str_cspan_space(line_tr.str, line_tr.len) };
+
+		// Parse line as %INCLUDE statement
+		if ((features & LANG_FEAT_INCLUDE) && parse_include_is(line_tok_first))
+			return parse_include(err, state, line_tr, line_tok_first.len);
 
 		// Parse line as non-instruction definitions
-		switch (str_ull(line_tok_first)) {
-			// DEFINE
-			case 0x444546494E45:
+		switch (token_get(str_ull_to(line_tok_first.str, line_tok_first.len, toupper))->directive) {
+			case DIRECTIVE_NONE_E:
+				break;
+
+			case DIRECTIVE_DEFINE_E:
 				if (!(features & LANG_FEAT_DEF_DATA))
 					break;
 
-				success = parse_def_data_define(err, &result->defs_data, line_num, line_toks);
-				goto exit;
+				if (!parse_line_split(err, state, line_tr))
+					return false;
+
+				return parse_def_data_define(err, state->file, &result->defs_data, &result->defs_data_map, line_num, state->line_toks);
 
-			// LABEL
-			case 0x4C4142454C:
+			case DIRECTIVE_LABEL_E:
 				if (!(features & LANG_FEAT_DEF_DATA))
 					break;
 
-				success = parse_def_data_label(err, &result->defs_data, line_num, line_toks, result->lines.len - result->refs_macros.len); // To avoid double-counting during assembly, macro references do not count towards instruction count
-				goto exit;
+				;
+				// To avoid double-counting during assembly, macro references do not count towards instruction count
+				size_t inst_num = result->lines.len - result->refs_macros.len;
+				if (state->scope == SCOPE_FILE_E)
+					inst_num += state->stream_insts;
+
+				if (!parse_line_split(err, state, line_tr))
+					return false;
+
+				return parse_def_data_label(err, state->file, &result->defs_data, &result->defs_data_map, line_num, state->line_toks, inst_num);
 
-			// %MACRO
-			case 0x254D4143524F:
+			case DIRECTIVE_MACRO_E:
 				if (!(features & LANG_FEAT_DEF_MACROS))
 					break;
 
 				// %MACRO statement only allowed in main scope
-				if (*scope != SCOPE_FILE_E || !defs_macros) {
+				if (state->scope != SCOPE_FILE_E || !state->defs_macros) {
 					error_init(err, ERRVAL_SYNTAX, "Nested %%MACRO statements not allowed");
-					goto exit;
+					return false;
 				}
 
 				// Parse %MACRO statement
-				if (!parse_def_macro(err, defs_macros, line_num, line_toks, features))
-					goto exit;
+				if (!parse_line_split(err, state, line_tr) || !parse_def_macro(err, state->file, state->defs_macros, state->defs_macros_map, line_num, state->line_toks, features))
+					return false;
 
 				// Change scope to macro
-				*scope = SCOPE_MACRO_E;
+				return parse_scope_set(err, state, SCOPE_MACRO_E);
 
-				success = true;
-				goto exit;
-
-			// %END
-			case 0x25454E44:
+			case DIRECTIVE_END_E:
 				if (!(features & LANG_FEAT_DEF_MACROS))
 					break;
 
 				// %END statement only allowed in macro scope
-				if (*scope != SCOPE_MACRO_E) {
+				if (state->scope != SCOPE_MACRO_E) {
 					error_init(err, ERRVAL_SYNTAX, "%%END statement must have an accompanying %%MACRO statement");
-					goto exit;
+					return false;
 				}
 
 				// Revert scope to file
-				*scope = SCOPE_FILE_E;
-
-				success = true;
-				goto exit;
+				return parse_scope_set(err, state, SCOPE_FILE_E);
 		}
 	}
 
-	// Remove all whitespace from line
-	if (!str_rm(line_st, line_tr, line_tr_len, isspace)) {
-		error_init(err, ERRVAL_FAILURE, "Failed to remove whitespace from string");
-		goto exit;
-	}
-
-	size_t line_st_len = strlen(line_st);
-	assert(line_st_len <= line_tr_len);
-
 	// Try parse line as ALU instruction
-	enum parse_inst_alu_result parse_inst_alu_result = parse_inst_alu(err, &result->lines, line_num, line_st, line_st_len, features);
+	enum parse_inst_alu_result parse_inst_alu_result = parse_inst_alu(err, &result->lines, line_num, line_tr, features);
 	switch (parse_inst_alu_result) {
 		case ALU_INST_FAILURE_E:
-			success = false;
-			break;
+			return false;
 		case ALU_INST_SUCCESS_E:
-			success = true;
-			break;
+			return true;
 		case ALU_INST_HINT_INST_DATA_E:
-			success = parse_inst_data(err, &result->lines, &result->refs_data, line_num, line_tr, line_tr_len, features);
-			break;
+			return parse_inst_data(err, syms, &result->lines, &result->refs_data, &result->refs_data_map, line_num, line_tr, features);
 		case ALU_INST_HINT_REF_MACRO_E:
-			success = parse_ref_macro(err, &result->lines, &result->refs_data, &result->refs_macros, line_num, line_toks, features);
-			break;
+			if (!parse_line_split(err, state, line_tr))
+				return false;
+
+			return parse_ref_macro(err, syms, &result->lines, &result->refs_data, &result->refs_data_map, &result->refs_macros, line_num, state->line_toks, features);
 		default:
 			error_init(err, ERRVAL_FAILURE, "Unknown ALU instruction parse result: %d", parse_inst_alu_result);
-			success = false;
-			break;
+			return false;
+	}
+}
+
+/**
+ * Pre-parse chunk of file, parsing instructions and classifying all other lines.
+ * Only the chunk itself is modified, so chunks can be pre-parsed concurrently.
+ *
+ * @param chunk Chunk to pre-parse, storing its result.
+ * @param features Enabled assembly language features.
+ */
+static void parse_chunk_prepare(struct parse_chunk* chunk, const int features)
+{
+	// Chunks may be pre-parsed concurrently - not allocating from arena of parsed file
+	struct parsed_lines alu_lines = { 0 };
+
+	for (size_t buf_ind = 0, next_ind; buf_ind < chunk->len; buf_ind += next_ind) {
+		chunk->lines_len++;
+
+		const char* line = &chunk->buf[buf_ind];
+		struct str_view line_full = { .str = line, .len = line_len_get(line, chunk->len - buf_ind, &next_ind) };
+		struct parse_chunk_line result = { .type = CHUNK_LINE_DEFERRED_E, .line_num = chunk->lines_len, .line_tr = str_view_trim(line_full) };
+
+		// Skip line if empty or comment
+		if (result.line_tr.len == 0 || result.line_tr.str[0] == '#')
+			continue;
+
+		// Statements are parsed in order, the same as parse_line()
+		enum token_directive directive = DIRECTIVE_NONE_E;
+		bool include = false;
+		if (features > 0) {
+			struct str_view line_tok_first = { .str = result.line_tr.str, .len = str_cspan_space(result.line_tr.str, result.line_tr.len) };
+			directive = token_get(str_ull_to(line_tok_first.str, line_tok_first.len, toupper))->directive;
+			include = parse_include_is(line_tok_first);
+		}
+
+		bool statement = ((directive == DIRECTIVE_DEFINE_E || directive == DIRECTIVE_LABEL_E) && (features & LANG_FEAT_DEF_DATA)) || ((directive == DIRECTIVE_MACRO_E || directive == DIRECTIVE_END_E) && (features & LANG_FEAT_DEF_MACROS)) || (include && (features & LANG_FEAT_INCLUDE));
+		if (!statement) {
+			switch (parse_inst_alu(&chunk->err, &alu_lines, result.line_num, result.line_tr, features)) {
+				case ALU_INST_FAILURE_E:
+					chunk->result = result.line_num;
+					goto exit;
+
+				case ALU_INST_SUCCESS_E:
+					result.type = CHUNK_LINE_INST_E;
+					result.val = (size_t)(ngc_uword_t)*dynarr_word_get(&alu_lines.vals, 0);
+					parsed_lines_clear(&alu_lines);
+					break;
+
+				case ALU_INST_HINT_INST_DATA_E:
+					result.type = CHUNK_LINE_INST_DATA_E;
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		if (!dynarr_chunk_line_push(&chunk->lines, result)) {
+			error_init(&chunk->err, ERRVAL_FAILURE, "Failed to push pre-parsed line");
+			chunk->result = result.line_num;
+			goto exit;
+		}
 	}
 
 	exit:
-	dynarr_empty(&line_toks);
-	return success;
+	parsed_lines_empty(&alu_lines);
 }
 
-size_t parse_file(struct error* err, struct parsed_file* file, FILE* fp, const int features)
+static void parse_chunk_prepare_v(void* p, size_t chunk_ind)
 {
-	if (!file) {
-		error_init(err, ERRVAL_FAILURE, "Result struct is null");
-		return 1;
+	struct parse_chunks* chunks = p;
+	parse_chunk_prepare(dynarr_parse_chunk_get(&chunks->vals, chunk_ind), chunks->features);
+}
+
+static void parse_chunk_empty_v(void* p) { dynarr_empty(&((struct parse_chunk*)p)->lines); }
+
+/**
+ * Parse pre-parsed lines of chunk in order, interning keys and tracking scopes.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file, storing number of line associated with error.
+ * @param chunk Pre-parsed chunk.
+ * @param line_num Number of last line of source file before chunk.
+ * @param line_num_shift Number of lines of included files before chunk, updated with lines of files included by chunk.
+ * @returns Whether all lines of chunk were valid and parsed successfully.
+ */
+static bool parse_chunk_lines(struct error* err, struct parse_state* state, const struct parse_chunk* chunk, const size_t line_num, size_t* line_num_shift)
+{
+	for (size_t lines_ind = 0; lines_ind < chunk->lines.len; lines_ind++) {
+		struct parse_chunk_line* line = dynarr_chunk_line_get(&chunk->lines, lines_ind);
+		struct parsed_base* result_scope = state->result_scope;
+		size_t line_num_file = line_num + line->line_num;
+		state->line_num = line_num_file + *line_num_shift;
+
+		bool line_parsed = false;
+		switch (line->type) {
+			case CHUNK_LINE_INST_E:
+				line_parsed = lines_push(err, &result_scope->lines, LINE_INST_E, state->line_num, line->val);
+				break;
+
+			case CHUNK_LINE_INST_DATA_E:
+				line_parsed = parse_inst_data(err, &state->file->syms, &result_scope->lines, &result_scope->refs_data, &result_scope->refs_data_map, state->line_num, line->line_tr, state->features);
+				break;
+
+			case CHUNK_LINE_DEFERRED_E:
+				line_parsed = parse_line(err, state, line->line_tr.str, line->line_tr.len);
+				break;
+		}
+
+		if (!line_parsed || !parse_stream_flush(err, state, false))
+			return false;
+
+		// Lines of included file are numbered before following lines
+		*line_num_shift = state->line_num - line_num_file;
 	}
 
-	if (!fp) {
-		error_init(err, ERRVAL_FAILURE, "File pointer is null");
-		return 1;
+	// Error pre-parsing chunk is reported once all lines before it are parsed
+	if (chunk->result > 0) {
+		*err = chunk->err;
+		state->line_num = line_num + chunk->result + *line_num_shift;
+		return false;
 	}
 
-	char f_line[STR_CHARS(FILE_COLS_MAX + 1)] = { 0 }; // +1 to detect when max exceeded
-	size_t line_num = 0;
+	return true;
+}
 
-	// Initialise scope - set to file
-	enum parsed_scope scope = SCOPE_FILE_E;
-	struct parsed_base* result_scope = &file->base;
-	struct dynarr* defs_macros = &file->defs_macros;
-
-	// Parse each line of file
-	while (fgets(f_line, sizeof(f_line), fp) != 0 && line_num <= FILE_LINES_MAX) {
-		line_num++;
-
-		// Check if too many lines in file
-		if (line_num > FILE_LINES_MAX) {
-			error_init(err, ERRVAL_FILE, "File contains too many lines (max %zu)", FILE_LINES_MAX);
-			return line_num;
+/**
+ * Parse assembly file split into chunks, pre-parsing chunks concurrently before parsing their lines in order.
+ * Keys are interned and scopes tracked in order, so the result is the same as parsing the whole file in order.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file, storing number of line associated with error.
+ * @param buf Contents of assembly file, does not need to be null-terminated.
+ * @param len Length of contents of assembly file.
+ * @param runner Runner of chunks.
+ * @returns Whether all lines were valid and parsed successfully.
+ */
+static bool parse_buf_chunks(struct error* err, struct parse_state* state, const char* buf, const size_t len, const struct runner* runner)
+{
+	size_t line_num = 0; // Number of last line of assembly file before chunk
+	size_t line_num_shift = 0; // Number of lines of included files before chunk
+	bool result = false;
+	struct parse_chunks chunks = { .features = state->features };
+
+	// Split file at first line boundary after each chunk size
+	for (size_t buf_ind = 0; buf_ind < len;) {
+		struct parse_chunk chunk = { .buf = &buf[buf_ind], .len = len - buf_ind };
+		if (chunk.len > PARSE_CHUNK_SIZE) {
+			const char* chunk_end = memchr(&chunk.buf[PARSE_CHUNK_SIZE - 1], '\n', chunk.len - PARSE_CHUNK_SIZE + 1);
+			if (chunk_end)
+				chunk.len = (size_t)(chunk_end - chunk.buf) + 1;
 		}
 
-		size_t f_line_len = strlen(f_line);
-
-		// Check if too many chars in line
-		if (f_line_len > FILE_COLS_MAX) {
-			error_init(err, ERRVAL_FILE, "File contains too many columns (max %zu)", FILE_COLS_MAX);
-			return line_num;
+		if (!dynarr_parse_chunk_push(&chunks.vals, chunk)) {
+			error_init(err, ERRVAL_FAILURE, "Failed to push file chunk");
+			goto exit;
 		}
 
-		// Parse line
-		enum parsed_scope scope_prev = scope;
-		if (!parse_line(err, result_scope, defs_macros, &scope, line_num, f_line, f_line_len, features))
-			return line_num;
-
-		// Line has changed scope - set up scope of next line to parse
-		if (scope != scope_prev) {
-			switch (scope) {
-				case SCOPE_FILE_E:
-					defs_macros = &file->defs_macros;
-					result_scope = &file->base;
-					break;
+		buf_ind += chunk.len;
+	}
 
-				case SCOPE_MACRO_E:
-					defs_macros = NULL;
+	runner->run(runner->ctx, parse_chunk_prepare_v, &chunks, chunks.vals.len);
 
-					// Get last macro definition
-					struct parsed_def_macro* def_macro = dynarr_get(file->defs_macros, file->defs_macros.len - 1);
-					if (!def_macro) {
-						error_init(err, ERRVAL_FAILURE, "Failed to find macro scope");
-						return line_num;
-					}
+	// Parse pre-parsed lines of each chunk in order
+	for (size_t chunk_ind = 0; chunk_ind < chunks.vals.len; chunk_ind++) {
+		struct parse_chunk* chunk = dynarr_parse_chunk_get(&chunks.vals, chunk_ind);
+		if (!parse_chunk_lines(err, state, chunk, line_num, &line_num_shift))
+			goto exit;
 
-					// Set destination to last macro
-					result_scope = &def_macro->base;
-					break;
+		line_num += chunk->lines_len;
+	}
 
-				default:
-					error_init(err, ERRVAL_FAILURE, "Unknown result scope: %d", scope);
-					return line_num;
-			}
-		}
+	state->line_num = line_num + line_num_shift;
+	result = true;
+
+	exit:
+	dynarr_delegate_empty(&chunks.vals, parse_chunk_empty_v);
+	return result;
+}
+
+/**
+ * Hash contents of included file, keying its cached record, or records of pre-parsed lines.
+ * Uses 64-bit FNV-1a - records are read back from the cache of the same user, so crafted collisions are not a concern.
+ *
+ * @param buf Buffer to hash.
+ * @param len Length of buffer.
+ * @returns Hash of buffer.
+ */
+static uint64_t parse_cache_hash(const char* buf, const size_t len)
+{
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (size_t buf_ind = 0; buf_ind < len; buf_ind++) {
+		hash ^= (unsigned char)buf[buf_ind];
+		hash *= 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * Load pre-parsed lines of included file from cached record, validating record matches file.
+ *
+ * @param chunk Whole included file as one chunk, storing its pre-parsed lines.
+ * @param rec Cached record.
+ * @param rec_len Length of cached record.
+ * @param hash Hash of contents of included file.
+ * @param features Enabled assembly language features.
+ * @returns Whether record was valid and loaded successfully. No lines are stored if record was invalid.
+ */
+static bool parse_cache_read(struct parse_chunk* chunk, const char* rec, const size_t rec_len, const uint64_t hash, const int features)
+{
+	struct parse_cache_header header;
+	if (rec_len < sizeof(header))
+		return false;
+
+	memcpy(&header, rec, sizeof(header));
+	size_t records_size = rec_len - sizeof(header);
+	if (header.magic != PARSE_CACHE_MAGIC || header.version != PARSE_CACHE_VERSION || header.hash != hash || header.len != chunk->len || header.features != (uint32_t)features || records_size % sizeof(struct parse_cache_line) != 0 || records_size / sizeof(struct parse_cache_line) != header.records_len)
+		return false;
+
+	if (parse_cache_hash(&rec[sizeof(header)], records_size) != header.records_hash)
+		return false;
+
+	// Failure to pre-allocate space is non-critical - not checking return result
+	dynarr_reserve(&chunk->lines, header.records_len, sizeof(struct parse_chunk_line));
+
+	// Lines are validated to be in order and within the file, so a corrupted record cannot read outside the file
+	size_t line_num = 0;
+	for (size_t records_ind = 0; records_ind < header.records_len; records_ind++) {
+		struct parse_cache_line rec_line;
+		memcpy(&rec_line, &rec[sizeof(header) + records_ind * sizeof(rec_line)], sizeof(rec_line));
+
+		if (rec_line.line_num <= line_num || rec_line.line_num > header.lines_len || rec_line.type > CHUNK_LINE_DEFERRED_E || rec_line.offset > chunk->len || rec_line.len > chunk->len - rec_line.offset)
+			goto error;
+
+		line_num = rec_line.line_num;
+		struct parse_chunk_line line = { .type = (enum parse_chunk_line_type)rec_line.type, .line_num = rec_line.line_num, .val = rec_line.val, .line_tr = { .str = &chunk->buf[rec_line.offset], .len = rec_line.len } };
+		if (!dynarr_chunk_line_push(&chunk->lines, line))
+			goto error;
+	}
+
+	chunk->lines_len = header.lines_len;
+	return true;
+
+	error:
+	chunk->lines.len = 0;
+	return false;
+}
+
+/**
+ * Store pre-parsed lines of included file as cached record.
+ * Caching is best-effort - files which fail to be stored are pre-parsed again next time.
+ *
+ * @param cache Cache to store record to.
+ * @param key Key of record.
+ * @param chunk Whole included file as one chunk, successfully pre-parsed.
+ * @param hash Hash of contents of included file.
+ * @param features Enabled assembly language features.
+ */
+static void parse_cache_write(const struct parse_cache* cache, const char* key, const struct parse_chunk* chunk, const uint64_t hash, const int features)
+{
+	// Ranges of lines are stored in 32 bits
+	if (chunk->len > UINT32_MAX)
+		return;
+
+	size_t rec_len = sizeof(struct parse_cache_header) + chunk->lines.len * sizeof(struct parse_cache_line);
+	char* rec = malloc(rec_len);
+	if (!rec)
+		return;
+
+	struct parse_cache_header header = { .magic = PARSE_CACHE_MAGIC, .version = PARSE_CACHE_VERSION, .hash = hash, .len = chunk->len, .features = (uint32_t)features, .lines_len = (uint32_t)chunk->lines_len, .records_len = (uint32_t)chunk->lines.len };
+
+	for (size_t lines_ind = 0; lines_ind < chunk->lines.len; lines_ind++) {
+		struct parse_chunk_line* line = dynarr_chunk_line_get(&chunk->lines, lines_ind);
+		struct parse_cache_line rec_line = { .line_num = (uint32_t)line->line_num, .offset = (uint32_t)(line->line_tr.str - chunk->buf), .len = (uint32_t)line->line_tr.len, .val = (uint16_t)line->val, .type = (uint16_t)line->type };
+		memcpy(&rec[sizeof(header) + lines_ind * sizeof(rec_line)], &rec_line, sizeof(rec_line));
+	}
+
+	header.records_hash = parse_cache_hash(&rec[sizeof(header)], rec_len - sizeof(header));
+	memcpy(rec, &header, sizeof(header));
+
+	cache->store(cache->ctx, key, rec, rec_len);
+	free(rec);
+}
+
+/**
+ * Parse lines of included file in order, loading its pre-parsed lines from cache if it was pre-parsed before.
+ * Pre-parsed lines only depend on the contents of the file and enabled features, so records are keyed by both and valid wherever the file is included.
+ * Keys are interned, definitions validated and labels counted when the lines are parsed in order, the same as a file which is not cached.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file, storing number of line associated with error.
+ * @param buf Contents of included file, does not need to be null-terminated.
+ * @param len Length of contents of included file.
+ * @returns Whether all lines were valid and parsed successfully.
+ */
+static bool parse_buf_cached(struct error* err, struct parse_state* state, const char* buf, const size_t len)
+{
+	const struct parse_cache* cache = state->cache;
+	struct parse_chunk chunk = { .buf = buf, .len = len };
+	uint64_t hash = parse_cache_hash(buf, len);
+
+	char key[PARSE_CACHE_KEY_LEN];
+	snprintf(key, sizeof(key), "%d-%x-%016llx-%llx", PARSE_CACHE_VERSION, (unsigned)state->features, (unsigned long long)hash, (unsigned long long)len);
+
+	size_t rec_len = 0;
+	char* rec = cache->load(cache->ctx, key, &rec_len);
+	bool loaded = rec && parse_cache_read(&chunk, rec, rec_len, hash, state->features);
+	free(rec);
+
+	// Files which fail to pre-parse are not stored, so the error is reported again from the file itself
+	if (!loaded) {
+		parse_chunk_prepare(&chunk, state->features);
+		if (chunk.result == 0)
+			parse_cache_write(cache, key, &chunk, hash, state->features);
+	}
+
+	size_t line_num = state->line_num;
+	size_t line_num_shift = 0;
+	bool result = parse_chunk_lines(err, state, &chunk, line_num, &line_num_shift);
+	if (result)
+		state->line_num = line_num + chunk.lines_len + line_num_shift;
+
+	dynarr_empty(&chunk.lines);
+	return result;
+}
+
+/**
+ * Parse assembly file, stopping if a macro reference is parsed while streaming.
+ *
+ * @param err Struct to store error.
+ * @param state State of parsed file, storing whether a macro reference was parsed while streaming.
+ * @param buf Contents of assembly file, does not need to be null-terminated.
+ * @param len Length of contents of assembly file.
+ * @param path Path of assembly file.
+ * @param runner Runner of chunks of file. NULL to parse on the calling thread.
+ * @returns 0 if successful, > 0 if error or a macro reference was parsed while streaming.
+ */
+static size_t parse_file_state(struct error* err, struct parse_state* state, const char* buf, const size_t len, const char* path, const struct runner* runner)
+{
+	struct parsed_file* file = state->file;
+	size_t result = 0;
+
+	// Token views of each line share one dynamic array to avoid allocating per line
+	// Failure to pre-allocate space is non-critical - not checking return result
+	dynarr_alloc(&state->line_toks, LINE_TOKS_CAPACITY_INIT, sizeof(struct str_view));
+
+	// Initialise scope - set to file
+	if (!parse_scope_set(err, state, SCOPE_FILE_E)) {
+		result = 1;
+		goto exit;
+	}
+
+	// Lines are numbered from first line of assembly file
+	long long file_path = sources_path_push(err, file, 0, 0, (struct str_view){ .str = path, .len = strlen(path) });
+	size_t file_path_ind = (file_path >= 0) ? (size_t)file_path : 0;
+	if (file_path < 0 || !sources_push(err, state, file_path_ind, 1)) {
+		result = 1;
+		goto exit;
+	}
+
+	if (!dynarr_size_push(&state->includes, file_path_ind)) {
+		error_init(err, ERRVAL_FAILURE, "Failed to push assembly file");
+		result = 1;
+		goto exit;
+	}
+
+	// Files with multiple chunks are pre-parsed concurrently
+	bool parsed = (runner && len > PARSE_CHUNK_SIZE) ? parse_buf_chunks(err, state, buf, len, runner) : parse_buf(err, state, buf, len);
+	if (!parsed) {
+		result = (state->line_num > 0) ? state->line_num : 1;
+		goto exit;
 	}
 
 	// Validate all macro definitions have been ended
-	if (scope != SCOPE_FILE_E) {
+	if (state->scope != SCOPE_FILE_E) {
 		error_init(err, ERRVAL_SYNTAX, "%%MACRO statement must have an accompanying %%END statement");
-		return line_num;
+		result = state->line_num;
+		goto exit;
+	}
+
+	// Pass remaining lines to stream
+	if (!parse_stream_flush(err, state, true)) {
+		result = (state->line_num > 0) ? state->line_num : 1;
+		goto exit;
 	}
 
-	return 0;
+	exit:
+	dynarr_empty(&state->line_toks);
+	dynarr_empty(&state->includes);
+	return result;
+}
+
+size_t parse_file(struct error* err, struct parsed_file* file, const char* buf, const size_t len, const char* path, const int features, const struct runner* runner, const struct parse_stream* stream, const struct parse_watch* watch, const struct parse_cache* cache)
+{
+	if (!file) {
+		error_init(err, ERRVAL_FAILURE, "Result struct is null");
+		return 1;
+	}
+
+	if (!buf && len > 0) {
+		error_init(err, ERRVAL_FAILURE, "File buffer is null");
+		return 1;
+	}
+
+	if (!path) {
+		error_init(err, ERRVAL_FAILURE, "File path is null");
+		return 1;
+	}
+
+	// Memory allocated while streaming is freed if file is parsed again
+	struct arena* arena = file->arena;
+	struct arena_mark arena_mark = arena_mark_get(arena);
+
+	struct parse_state state = { .file = file, .features = features, .stream = stream, .watch = watch, .cache = cache };
+	size_t result = parse_file_state(err, &state, buf, len, path, runner);
+	if (!state.stream_ref_macro)
+		return result;
+
+	// Macros are expanded from the stored lines of the file - parse file again from the start, storing all lines
+	parsed_file_empty(file);
+	arena_reset(arena, arena_mark);
+	*file = (struct parsed_file){ 0 };
+	parsed_file_alloc(file, arena);
+
+	state = (struct parse_state){ .file = file, .features = features, .watch = watch, .cache = cache };
+	return parse_file_state(err, &state, buf, len, path, runner);
 }
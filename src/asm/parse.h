@@ -3,16 +3,46 @@
 
 #include "err.h"
 #include "parsed.h"
+#include "runner.h"
 
-#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
 
 #define LANG_FEAT_DEF_DATA         (1 << 0)
 #define LANG_FEAT_DEF_MACROS       (1 << 1)
 #define LANG_FEAT_DEF_MACRO_PARAMS (1 << 2)
-#define LANG_FEAT_ALL              (LANG_FEAT_DEF_DATA | LANG_FEAT_DEF_MACROS | LANG_FEAT_DEF_MACRO_PARAMS)
+#define LANG_FEAT_INCLUDE          (1 << 3)
+#define LANG_FEAT_ALL              (LANG_FEAT_DEF_DATA | LANG_FEAT_DEF_MACROS | LANG_FEAT_DEF_MACRO_PARAMS | LANG_FEAT_INCLUDE)
+
+/**
+ * Stream of lines parsed within root/file scope, consumed in order as they are parsed rather than stored.
+ */
+struct parse_stream {
+	bool (*line)(void* ctx, struct error* err, const struct parsed_file* file, const struct parsed_line line);
+	void* ctx;
+};
+
+/**
+ * Watcher of files included by assembly file, notified before each included file is read.
+ */
+struct parse_watch {
+	void (*include)(void* ctx, const char* path);
+	void* ctx;
+};
+
+/**
+ * Cache of included files pre-parsed by a previous run, keyed by their contents and the features they were pre-parsed with.
+ * Records only hold what does not depend on the including file - keys are interned and definitions validated each time a file is included.
+ */
+struct parse_cache {
+	char* (*load)(void* ctx, const char* key, size_t* len); // Returns record allocated with malloc(), freed by caller. NULL if not cached
+	void (*store)(void* ctx, const char* key, const char* buf, size_t len);
+	void* ctx;
+};
 
 /**
  * Parse number, between 0 and NGC_WORD_MAX (0x7FFF) inclusive.
+ * Tokens longer than 0xFD chars are invalid.
  *
  * @param tok Token to parse.
  * @param len Length of token to parse.
@@ -25,10 +55,17 @@ long parse_number(const char* tok, const size_t len);
  *
  * @param err Struct to store error.
  * @param result Struct to store parsed file.
- * @param fp Assembly file pointer.
+ * @param buf Contents of assembly file, does not need to be null-terminated.
+ * @param len Length of contents of assembly file.
+ * @param path Path of assembly file, which paths of included files are relative to.
  * @param features Enabled assembly language features.
- * @returns 0 if successful, > 0 if error. Returns which line is associated with error when err->val is ERRVAL_SYNTAX.
+ * @param runner Runner of chunks of file, parsed concurrently. NULL to parse on the calling thread.
+ * @param stream Stream to pass lines of root/file scope to rather than storing them, unless the file references macros. NULL to store all lines.
+ *               Files referencing macros are parsed again from the start storing all lines, so lines of root/file scope were only streamed if none are stored.
+ * @param watch Watcher to notify before reading each included file, including files read again when parsing again from the start. NULL if not watching files.
+ * @param cache Cache to load pre-parsed included files from, and store them to. NULL to pre-parse included files each time.
+ * @returns 0 if successful, > 0 if error. Returns which line is associated with error when err->val is ERRVAL_SYNTAX, numbered across the assembly file and all files it includes.
  */
-size_t parse_file(struct error* err, struct parsed_file* result, FILE* fp, const int features);
+size_t parse_file(struct error* err, struct parsed_file* result, const char* buf, const size_t len, const char* path, const int features, const struct runner* runner, const struct parse_stream* stream, const struct parse_watch* watch, const struct parse_cache* cache);
 
 #endif
@@ -1,76 +1,188 @@
 #include "parsed.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #define PARSED_LINES_CAPACITY_INIT  8
 #define PARSED_DATA_CAPACITY_INIT   2
 #define PARSED_MACROS_CAPACITY_INIT 2
 
-void parsed_def_macro_alloc(struct parsed_def_macro* def_macro)
+void parsed_lines_alloc(struct parsed_lines* lines, struct arena* arena)
+{
+	if (!lines)
+		return;
+
+	lines->vals.arena = arena;
+	lines->types.arena = arena;
+	lines->refs.arena = arena;
+	lines->line_nums.arena = arena;
+
+	// Failure to pre-allocate space is non-critical - not checking return results
+	dynarr_alloc(&lines->vals, PARSED_LINES_CAPACITY_INIT, sizeof(ngc_word_t));
+	dynarr_alloc(&lines->types, PARSED_LINES_CAPACITY_INIT, sizeof(uint8_t));
+
+	// No space pre-allocated for references or line numbers
+}
+
+void parsed_def_macro_alloc(struct parsed_def_macro* def_macro, struct arena* arena)
 {
 	if (!def_macro)
 		return;
 
-	parsed_base_alloc(&def_macro->base);
+	def_macro->params.arena = arena;
+	def_macro->params_map.arena = arena;
+	parsed_base_alloc(&def_macro->base, arena);
 
 	// No space pre-allocated for macro parameters
 }
 
-void parsed_base_alloc(struct parsed_base* base)
+void parsed_base_alloc(struct parsed_base* base, struct arena* arena)
 {
 	if (!base)
 		return;
 
+	parsed_lines_alloc(&base->lines, arena);
+	base->refs_data.arena = arena;
+	base->refs_macros.arena = arena;
+	base->defs_data.arena = arena;
+	base->refs_data_map.arena = arena;
+	base->defs_data_map.arena = arena;
+
 	// Failure to pre-allocate space is non-critical - not checking return results
-	dynarr_alloc(&base->lines, PARSED_LINES_CAPACITY_INIT, sizeof(struct parsed_line));
-	dynarr_alloc(&base->refs_data, PARSED_DATA_CAPACITY_INIT, sizeof(char[PARSED_KEY_CHARS]));
+	dynarr_alloc(&base->refs_data, PARSED_DATA_CAPACITY_INIT, sizeof(symbol_t));
 	dynarr_alloc(&base->refs_macros, PARSED_MACROS_CAPACITY_INIT, sizeof(struct parsed_ref_macro));
 	dynarr_alloc(&base->defs_data, PARSED_DATA_CAPACITY_INIT, sizeof(struct parsed_def_data));
 
 	// No space pre-allocated for macro parameters
 }
 
-void parsed_file_alloc(struct parsed_file* file)
+void parsed_file_alloc(struct parsed_file* file, struct arena* arena)
 {
 	if (!file)
 		return;
 
-	parsed_base_alloc(&file->base);
+	file->arena = arena;
+	file->defs_macros.arena = arena;
+	file->defs_macros_map.arena = arena;
+	file->syms.arena = arena;
+	file->sources.arena = arena;
+	file->sources_paths.arena = arena;
+	parsed_base_alloc(&file->base, arena);
 	dynarr_alloc(&file->defs_macros, PARSED_MACROS_CAPACITY_INIT, sizeof(struct parsed_def_macro)); // Failure to pre-allocate space is non-critical - not checking return result
 }
 
-struct parsed_def_data* parsed_def_data_get(const struct dynarr defs_data, const char* key)
+bool parsed_lines_push(struct parsed_lines* lines, const struct parsed_line line)
 {
-	if (!key)
-		return NULL;
+	// Line number is stored in full if it doesn't fit within the type of line
+	size_t line_num_diff = line.line_num - lines->line_num;
+	if (line.line_num < lines->line_num || line_num_diff >= PARSED_LINE_NUM_DIFF_FAR)
+		line_num_diff = PARSED_LINE_NUM_DIFF_FAR;
+
+	uint8_t type = (uint8_t)((unsigned int)line.type | (line_num_diff << PARSED_LINE_TYPE_BITS));
+	ngc_word_t val = (line.type == LINE_INST_E) ? (ngc_word_t)line.val : 0;
+
+	// Arrays are restored to their previous length if any push fails, keeping them parallel
+	size_t refs_len = lines->refs.len, line_nums_len = lines->line_nums.len, vals_len = lines->vals.len;
+	if (line.type != LINE_INST_E && !dynarr_size_push(&lines->refs, line.val))
+		goto error;
+
+	if (line_num_diff == PARSED_LINE_NUM_DIFF_FAR && !dynarr_size_push(&lines->line_nums, line.line_num))
+		goto error;
+
+	if (!dynarr_word_push(&lines->vals, val) || !dynarr_byte_push(&lines->types, type))
+		goto error;
+
+	lines->len++;
+	lines->line_num = line.line_num;
+	return true;
+
+	error:
+	lines->refs.len = refs_len;
+	lines->line_nums.len = line_nums_len;
+	lines->vals.len = vals_len;
+	return false;
+}
 
-	for (size_t data_ind = 0; data_ind < defs_data.len; data_ind++) {
-		struct parsed_def_data* data = dynarr_get(defs_data, data_ind);
-		if (!data)
-			continue;
+bool parsed_lines_next(const struct parsed_lines* lines, struct parsed_lines_iter* iter, struct parsed_line* line)
+{
+	if (iter->ind >= lines->len)
+		return false;
 
-		if (PARSED_KEYS_EQ(data->key, key))
-			return data;
-	}
+	const ngc_word_t* vals = lines->vals.vals;
+	const uint8_t* types = lines->types.vals;
+	const size_t* refs = lines->refs.vals;
+	const size_t* line_nums = lines->line_nums.vals;
 
-	return NULL;
+	size_t line_num_diff = (size_t)(types[iter->ind] >> PARSED_LINE_TYPE_BITS);
+	iter->line_num = (line_num_diff == PARSED_LINE_NUM_DIFF_FAR) ? line_nums[iter->line_nums_ind++] : iter->line_num + line_num_diff;
+
+	line->type = (enum parsed_line_type)(types[iter->ind] & ((1U << PARSED_LINE_TYPE_BITS) - 1));
+	line->line_num = iter->line_num;
+	line->val = (line->type == LINE_INST_E) ? (size_t)(ngc_uword_t)vals[iter->ind] : refs[iter->refs_ind++];
+
+	iter->ind++;
+	return true;
 }
 
-struct parsed_def_macro* parsed_def_macro_get(const struct dynarr defs_macros, const char* key)
+void parsed_lines_clear(struct parsed_lines* lines)
 {
-	if (!key)
-		return NULL;
+	if (!lines)
+		return;
 
-	for (size_t macro_ind = 0; macro_ind < defs_macros.len; macro_ind++) {
-		struct parsed_def_macro* macro = dynarr_get(defs_macros, macro_ind);
-		if (!macro)
-			continue;
+	lines->len = 0;
+	lines->line_num = 0;
+	lines->vals.len = 0;
+	lines->types.len = 0;
+	lines->refs.len = 0;
+	lines->line_nums.len = 0;
+}
+
+struct parsed_def_data* parsed_def_data_get(const struct dynarr defs_data, const struct keymap defs_data_map, const symbol_t key)
+{
+	long long data_ind = keymap_get(defs_data_map, key);
+	return (data_ind >= 0) ? dynarr_parsed_def_data_get(&defs_data, (size_t)data_ind) : NULL;
+}
+
+struct parsed_def_macro* parsed_def_macro_get(const struct dynarr defs_macros, const struct keymap defs_macros_map, const symbol_t key)
+{
+	long long macro_ind = keymap_get(defs_macros_map, key);
+	return (macro_ind >= 0) ? dynarr_parsed_def_macro_get(&defs_macros, (size_t)macro_ind) : NULL;
+}
 
-		if (PARSED_KEYS_EQ(macro->key, key))
-			return macro;
+struct parsed_loc parsed_file_loc(const struct parsed_file file, const size_t line_num)
+{
+	struct parsed_loc result = { .path = NULL, .line_num = line_num };
+
+	// Binary search for last range starting at or before line
+	size_t low = 0, high = file.sources.len;
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		if (dynarr_parsed_source_get(&file.sources, mid)->line_num <= line_num)
+			low = mid + 1;
+		else
+			high = mid;
 	}
 
-	return NULL;
+	struct parsed_source* source = (low > 0) ? dynarr_parsed_source_get(&file.sources, low - 1) : NULL;
+	if (!source)
+		return result;
+
+	result.path = dynarr_char_get(&file.sources_paths, source->path);
+	result.line_num = source->line_num_source + (line_num - source->line_num);
+	return result;
+}
+
+void parsed_lines_empty(struct parsed_lines* lines)
+{
+	if (!lines)
+		return;
+
+	dynarr_empty(&lines->vals);
+	dynarr_empty(&lines->types);
+	dynarr_empty(&lines->refs);
+	dynarr_empty(&lines->line_nums);
+	lines->len = 0;
+	lines->line_num = 0;
 }
 
 void parsed_ref_macro_empty(struct parsed_ref_macro* ref_macro)
@@ -88,10 +200,12 @@ void parsed_base_empty(struct parsed_base* base)
 	if (!base)
 		return;
 
-	dynarr_empty(&base->lines);
+	parsed_lines_empty(&base->lines);
 	dynarr_empty(&base->refs_data);
 	dynarr_delegate_empty(&base->refs_macros, parsed_ref_macro_empty_v);
 	dynarr_empty(&base->defs_data);
+	keymap_empty(&base->refs_data_map);
+	keymap_empty(&base->defs_data_map);
 }
 
 void parsed_def_macro_empty(struct parsed_def_macro* def_macro)
@@ -101,6 +215,7 @@ void parsed_def_macro_empty(struct parsed_def_macro* def_macro)
 
 	parsed_base_empty(&def_macro->base);
 	dynarr_empty(&def_macro->params);
+	keymap_empty(&def_macro->params_map);
 }
 
 static void parsed_def_macro_empty_v(void* p) { parsed_def_macro_empty(p); }
@@ -112,4 +227,8 @@ void parsed_file_empty(struct parsed_file* file)
 
 	parsed_base_empty(&file->base);
 	dynarr_delegate_empty(&file->defs_macros, parsed_def_macro_empty_v);
+	keymap_empty(&file->defs_macros_map);
+	symbols_empty(&file->syms);
+	dynarr_empty(&file->sources);
+	dynarr_empty(&file->sources_paths);
 }
@@ -1,15 +1,24 @@
 #ifndef PARSED_H
 #define PARSED_H
 
+#include "../arena.h"
 #include "../dynarr.h"
+#include "../ngc.h"
+#include "../object.h"
+#include "keymap.h"
 #include "str.h"
+#include "symbols.h"
 
-#include <ctype.h>
+#include <stdbool.h>
 
-#define PARSED_KEY_LEN_MAX 0x3F
+DYNARR_DEFINE(ngc_word_t, word)
+
+#define PARSED_KEY_LEN_MAX OBJECT_KEY_LEN_MAX // Keys are written to object files unchanged
 #define PARSED_KEY_CHARS STR_CHARS(PARSED_KEY_LEN_MAX)
 #define PARSED_KEY_SIZE STR_SIZE(PARSED_KEY_LEN_MAX)
-#define PARSED_KEYS_EQ(k1, k2) (str_comp(k1, k2, PARSED_KEY_LEN_MAX, tolower) == 0)
+
+#define PARSED_LINE_TYPE_BITS 2 // Number of bits of parsed_lines.types storing type of line
+#define PARSED_LINE_NUM_DIFF_FAR 0x3F // Increase in line number stored within parsed_lines.types if line number is stored within parsed_lines.line_nums instead
 
 /**
  * Type of parsed assembly line.
@@ -21,7 +30,7 @@ enum parsed_line_type {
 };
 
 /**
- * Parsed assembly line.
+ * Parsed assembly line, as pushed to or read from parsed lines.
  */
 struct parsed_line {
 	enum parsed_line_type type;
@@ -29,6 +38,29 @@ struct parsed_line {
 	size_t val; // Parsed instruction if type is LINE_INST_E, index of parsed_base.refs_* if type is LINE_REF_*_E
 };
 
+/**
+ * Parsed assembly lines, stored as parallel arrays of one value per line.
+ * Line numbers are stored as the increase from the previous line, only needed to report errors.
+ */
+struct parsed_lines {
+	size_t len; // Number of lines
+	size_t line_num; // Number of last line pushed
+	struct dynarr vals; // Dynamic array of ngc_word_t, parsed instruction of each line, 0 if line is a reference
+	struct dynarr types; // Dynamic array of uint8_t, type of each line within the low PARSED_LINE_TYPE_BITS bits, increase in line number from the previous line within the remaining bits
+	struct dynarr refs; // Dynamic array of size_t, index of parsed_base.refs_* of each line referencing data or a macro, in order of line
+	struct dynarr line_nums; // Dynamic array of size_t, number of each line with an increase in line number of PARSED_LINE_NUM_DIFF_FAR or more, in order of line
+};
+
+/**
+ * Position within parsed assembly lines, reading lines in order.
+ */
+struct parsed_lines_iter {
+	size_t ind; // Index of next line
+	size_t refs_ind; // Index of parsed_lines.refs of next line referencing data or a macro
+	size_t line_nums_ind; // Index of parsed_lines.line_nums of next line with its line number stored
+	size_t line_num; // Number of previous line
+};
+
 /**
  * Type of parsed parameter of macro reference.
  */
@@ -45,14 +77,18 @@ struct parsed_ref_macro_param {
 	size_t val; // Parsed number if type is PARAM_CONST_E, index of parsed_base.refs_data if type is PARAM_REF_DATA_E
 };
 
+DYNARR_DEFINE(struct parsed_ref_macro_param, parsed_ref_macro_param)
+
 /**
  * Parsed macro reference.
  */
 struct parsed_ref_macro {
-	char key[PARSED_KEY_CHARS];
+	symbol_t key;
 	struct dynarr params; // Dynamic array of parsed_ref_macro_param
 };
 
+DYNARR_DEFINE(struct parsed_ref_macro, parsed_ref_macro)
+
 /**
  * Type of parsed data definition.
  */
@@ -65,72 +101,154 @@ enum parsed_def_data_type {
  * Parsed data definition (DEFINE or LABEL statement).
  */
 struct parsed_def_data {
-	char key[PARSED_KEY_CHARS];
+	symbol_t key;
 	enum parsed_def_data_type type;
 	size_t line_num;
 	size_t val; // Parsed number if type is DATA_CONST_E, instruction count if type is DATA_LABEL_E
 };
 
+DYNARR_DEFINE(struct parsed_def_data, parsed_def_data)
+
 /**
  * Base result of parsed assembly.
  */
 struct parsed_base {
-	struct dynarr lines; // Dynamic array of parsed_line
-	struct dynarr refs_data; // Dynamic array of char[PARSED_KEY_CHARS]
+	struct parsed_lines lines;
+	struct dynarr refs_data; // Dynamic array of symbol_t
 	struct dynarr refs_macros; // Dynamic array of parsed_ref_macro
 	struct dynarr defs_data; // Dynamic array of parsed_def_data
+	struct keymap refs_data_map; // Key map of refs_data
+	struct keymap defs_data_map; // Key map of defs_data
 };
 
 /**
  * Parsed macro definition.
  */
 struct parsed_def_macro {
-	char key[PARSED_KEY_CHARS];
+	symbol_t key;
 	size_t line_num;
-	struct dynarr params; // Dynamic array of char[PARSED_KEY_CHARS]
+	struct dynarr params; // Dynamic array of symbol_t
+	struct keymap params_map; // Key map of params
 	struct parsed_base base;
 };
 
+DYNARR_DEFINE(struct parsed_def_macro, parsed_def_macro)
+
+/**
+ * Range of lines of parsed file read from one source file, either the assembly file or a file it includes.
+ * Lines are numbered across all source files, in the order they were parsed.
+ */
+struct parsed_source {
+	size_t path; // Offset of null-terminated path of source file within parsed_file.sources_paths
+	size_t line_num; // Number of first line of range
+	size_t line_num_source; // Number of first line of range within source file
+};
+
+DYNARR_DEFINE(struct parsed_source, parsed_source)
+
+/**
+ * Location of line of parsed file within the source file it was read from.
+ */
+struct parsed_loc {
+	const char* path; // Null-terminated path of source file, NULL if parsed file has no source files
+	size_t line_num; // Number of line within source file
+};
+
 /**
  * Parsed assembly file.
  */
 struct parsed_file {
 	struct parsed_base base;
 	struct dynarr defs_macros; // Dynamic array of parsed_def_macro
+	struct keymap defs_macros_map; // Key map of defs_macros
+	struct symbols syms; // Pool of keys interned while parsing
+	struct dynarr sources; // Dynamic array of parsed_source, in order of line numbers
+	struct dynarr sources_paths; // Dynamic array of char, null-terminated paths of source files
+	struct arena* arena; // Arena values of parsed file are allocated from, NULL if allocated individually
 };
 
+/**
+ * Pre-allocate initial space for parsed assembly lines.
+ * Values will be allocated from arena if given, otherwise values are allocated individually.
+ */
+void parsed_lines_alloc(struct parsed_lines* lines, struct arena* arena);
+
 /**
  * Pre-allocate initial space for parsed macro definition.
+ * Values will be allocated from arena if given, otherwise values are allocated individually.
  */
-void parsed_def_macro_alloc(struct parsed_def_macro* def_macro);
+void parsed_def_macro_alloc(struct parsed_def_macro* def_macro, struct arena* arena);
 
 /**
  * Pre-allocate initial space for parsed assembly.
+ * Values will be allocated from arena if given, otherwise values are allocated individually.
  */
-void parsed_base_alloc(struct parsed_base* base);
+void parsed_base_alloc(struct parsed_base* base, struct arena* arena);
 
 /**
  * Pre-allocate initial space for parsed file.
+ * Values will be allocated from arena if given, otherwise values are allocated individually.
+ * Values allocated from arena are freed by freeing the arena, making parsed_file_empty() unnecessary.
+ */
+void parsed_file_alloc(struct parsed_file* file, struct arena* arena);
+
+/**
+ * Push parsed line to end of parsed assembly lines.
+ *
+ * @param lines Parsed assembly lines to push line to.
+ * @param line Parsed line to push.
+ * @returns Whether parsed line was pushed successfully.
+ */
+bool parsed_lines_push(struct parsed_lines* lines, const struct parsed_line line);
+
+/**
+ * Read next line of parsed assembly lines.
+ *
+ * @param lines Parsed assembly lines to read line from.
+ * @param iter Position within lines to read from, zero-initialised to read from the first line. Advanced past line read.
+ * @param line Struct to store parsed line.
+ * @returns Whether a line was read. False if all lines were read.
+ */
+bool parsed_lines_next(const struct parsed_lines* lines, struct parsed_lines_iter* iter, struct parsed_line* line);
+
+/**
+ * Remove all lines of parsed assembly lines, keeping space allocated for lines pushed afterwards.
  */
-void parsed_file_alloc(struct parsed_file* file);
+void parsed_lines_clear(struct parsed_lines* lines);
 
 /**
  * Get parsed data definition from array using key.
  *
  * @param defs_data Dynamic array of parsed data definitions.
- * @param key Key of data definition to get.
+ * @param defs_data_map Key map of parsed data definitions.
+ * @param key Interned key of data definition to get.
  * @returns Pointer to data definition. NULL if not found.
  */
-struct parsed_def_data* parsed_def_data_get(const struct dynarr defs_data, const char* key);
+struct parsed_def_data* parsed_def_data_get(const struct dynarr defs_data, const struct keymap defs_data_map, const symbol_t key);
 
 /**
  * Get parsed macro definition from array using key.
  *
  * @param defs_macros Dynamic array of parsed macro definitions.
- * @param key Key of macro definition to get.
+ * @param defs_macros_map Key map of parsed macro definitions.
+ * @param key Interned key of macro definition to get.
  * @returns Pointer to parsed macro definition. NULL if not found.
  */
-struct parsed_def_macro* parsed_def_macro_get(const struct dynarr defs_macros, const char* key);
+struct parsed_def_macro* parsed_def_macro_get(const struct dynarr defs_macros, const struct keymap defs_macros_map, const symbol_t key);
+
+/**
+ * Get location of line of parsed file within the source file it was read from.
+ *
+ * @param file Parsed file.
+ * @param line_num Number of line, numbered across all source files.
+ * @returns Location of line. Line number is unchanged if parsed file has no source files.
+ */
+struct parsed_loc parsed_file_loc(const struct parsed_file file, const size_t line_num);
+
+/**
+ * Free values within parsed assembly lines.
+ */
+void parsed_lines_empty(struct parsed_lines* lines);
 
 /**
  * Free values within parsed macro reference.
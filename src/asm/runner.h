@@ -0,0 +1,23 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include <stddef.h>
+
+/**
+ * Runner of independent jobs, e.g. a pool of threads.
+ */
+struct runner {
+	/**
+	 * Run all jobs, returning once every job has finished.
+	 * Jobs are independent, so can be run in any order and concurrently.
+	 *
+	 * @param ctx Context of runner.
+	 * @param job Function running job at index.
+	 * @param jobs_ctx Context of jobs, passed to job function.
+	 * @param jobs_len Number of jobs.
+	 */
+	void (*run)(void* ctx, void (*job)(void* jobs_ctx, size_t job_ind), void* jobs_ctx, const size_t jobs_len);
+	void* ctx;
+};
+
+#endif
@@ -5,6 +5,55 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+#define STR_SIMD_LEN 16 // Number of chars classified at once
+
+/**
+ * Get index of first unset bit in mask of classified chars.
+ * Mask must have at least one unset bit within its lowest STR_SIMD_LEN bits.
+ */
+static size_t str_simd_first_unset(const unsigned int mask)
+{
+	#ifdef __GNUC__
+	return (size_t)__builtin_ctz(~mask);
+	#else
+	size_t ind = 0;
+	for (unsigned int bits = mask; bits & 1; bits >>= 1)
+		ind++;
+
+	return ind;
+	#endif
+}
+
+/**
+ * Classify chars as whitespace (space, or \t through \r).
+ */
+static __m128i str_simd_is_space(const __m128i chars)
+{
+	__m128i ctrl = _mm_sub_epi8(chars, _mm_set1_epi8('\t'));
+	__m128i is_ctrl = _mm_cmpeq_epi8(_mm_min_epu8(ctrl, _mm_set1_epi8('\r' - '\t')), ctrl); // Unsigned ctrl <= '\r' - '\t'
+	return _mm_or_si128(is_ctrl, _mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')));
+}
+
+/**
+ * Classify chars as alphanumeric, underscore, or period.
+ */
+static __m128i str_simd_is_ident(const __m128i chars)
+{
+	__m128i alpha = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a')); // Lowercase letters
+	__m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+	__m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8('z' - 'a')), alpha);
+	__m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8('9' - '0')), digit);
+	__m128i is_punct = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('_')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('.')));
+	return _mm_or_si128(_mm_or_si128(is_alpha, is_digit), is_punct);
+}
+#endif
+
+static int is_space(const char ch) { return ch == ' ' || (ch >= '\t' && ch <= '\r'); }
+static int is_ident(const char ch) { return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') || ch == '_' || ch == '.'; }
+
 char* str_copy(char* dst, const char* src, const size_t len)
 {
 	if (!dst || !src)
@@ -95,56 +144,132 @@ int str_comp(const char* s1, const char* s2, const size_t len, int (*to)(const i
 	return 0;
 }
 
-long long str_split(struct dynarr* da, const char* src, const size_t len, const char* delim)
+struct str_view str_view_trim(const struct str_view src)
 {
-	if (!src)
-		return -1;
+	struct str_view result = src;
+
+	if (!result.str)
+		return result;
+
+	size_t space_len = str_span_space(result.str, result.len);
+	result.str += space_len;
+	result.len -= space_len;
 
-	long long result = 0;
-	size_t token_ind = strspn(src, delim); // Start after any prefixed delim
-	size_t token_len;
+	while (result.len > 0 && is_space(result.str[result.len - 1])) {
+		result.len--;
+	}
 
-	do {
-		// Get length of token
-		token_len = strcspn(&src[token_ind], delim);
-		if (token_len == 0)
-			break;
+	return result;
+}
 
-		// Limit length to max total chars
-		if (token_ind + token_len > len)
-			token_len -= (token_ind + token_len) - len;
+long long str_view_split(struct dynarr* da, const struct str_view src)
+{
+	if (!da || !src.str)
+		return -1;
 
-		// Copy token to string sized for dynamic array
-		char token[STR_CHARS(len)];
-		if (!str_copy(token, &src[token_ind], token_len))
-			return -1;
+	// Replace existing views
+	da->len = 0;
 
-		// Push copy of token to dynamic array
-		if (!dynarr_push(da, token, sizeof(token)))
+	for (size_t ind = str_span_space(src.str, src.len); ind < src.len;) {
+		// Get token up to next whitespace
+		struct str_view token = { .str = &src.str[ind], .len = str_cspan_space(&src.str[ind], src.len - ind) };
+
+		// Push view of token to dynamic array
+		if (!dynarr_str_view_push(da, token))
 			return -1;
 
-		// Add token length + any proceeding delim to get index of next token
-		token_ind += token_len;
-		token_ind += strspn(&src[token_ind], delim);
+		// Skip token and any proceeding whitespace
+		ind += token.len;
+		ind += str_span_space(&src.str[ind], src.len - ind);
+	}
+
+	return (long long)da->len;
+}
+
+size_t str_span_space(const char* str, const size_t len)
+{
+	size_t ind = 0;
 
-		result++;
-	} while (token_len > 0);
+	#ifdef __SSE2__
+	for (; ind + STR_SIMD_LEN <= len; ind += STR_SIMD_LEN) {
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(str_simd_is_space(_mm_loadu_si128((const __m128i*)&str[ind])));
+		if (mask != 0xFFFF)
+			return ind + str_simd_first_unset(mask);
+	}
+	#endif
+
+	while (ind < len && is_space(str[ind])) {
+		ind++;
+	}
+
+	return ind;
+}
+
+size_t str_cspan_space(const char* str, const size_t len)
+{
+	size_t ind = 0;
+
+	#ifdef __SSE2__
+	for (; ind + STR_SIMD_LEN <= len; ind += STR_SIMD_LEN) {
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(str_simd_is_space(_mm_loadu_si128((const __m128i*)&str[ind])));
+		if (mask != 0)
+			return ind + str_simd_first_unset(~mask);
+	}
+	#endif
+
+	while (ind < len && !is_space(str[ind])) {
+		ind++;
+	}
+
+	return ind;
+}
+
+size_t str_span_ident(const char* str, const size_t len)
+{
+	size_t ind = 0;
+
+	#ifdef __SSE2__
+	for (; ind + STR_SIMD_LEN <= len; ind += STR_SIMD_LEN) {
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(str_simd_is_ident(_mm_loadu_si128((const __m128i*)&str[ind])));
+		if (mask != 0xFFFF)
+			return ind + str_simd_first_unset(mask);
+	}
+	#endif
+
+	while (ind < len && is_ident(str[ind])) {
+		ind++;
+	}
+
+	return ind;
+}
+
+unsigned long long str_ull_to(const char* str, const size_t len, int (*to)(const int))
+{
+	unsigned long long result = 0;
+
+	if (!str)
+		return result;
+
+	for (size_t ind = 0; ind < len && ind < STRULL_MAX_LEN && str[ind] != '\0'; ind++) {
+		result = (result << (8 * sizeof(char))) | (unsigned char)to(str[ind]);
+	}
 
 	return result;
 }
 
-unsigned long long str_ull(const char* str)
+unsigned long long str_ull_rm(const char* str, const size_t len, int (*is)(const int))
 {
 	unsigned long long result = 0;
 
 	if (!str)
 		return result;
 
-	size_t str_len = strlen(str);
-	size_t len = (str_len > STRULL_MAX_LEN) ? STRULL_MAX_LEN : str_len;
+	for (size_t ind = 0, result_len = 0; ind < len && result_len < STRULL_MAX_LEN && str[ind] != '\0'; ind++) {
+		if (is(str[ind]))
+			continue;
 
-	for (size_t ind = 0; ind < len; ind++) {
-		result |= (unsigned long long)str[ind] << (8 * sizeof(char) * (len - ind - 1));
+		result = (result << (8 * sizeof(char))) | (unsigned char)str[ind];
+		result_len++;
 	}
 
 	return result;
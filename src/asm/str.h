@@ -12,6 +12,20 @@
 // Chars which are considered whitespace, should be the same as isspace()
 #define WHITESPACE " \t\n\v\f\r"
 
+// printf() format and arguments of string view
+#define STR_VIEW_FMT "%.*s"
+#define STR_VIEW_ARG(view) (int)(view).len, (view).str
+
+/**
+ * View of chars within a string, not null-terminated.
+ */
+struct str_view {
+	const char* str;
+	size_t len;
+};
+
+DYNARR_DEFINE(struct str_view, str_view)
+
 /**
  * Copy string.
  *
@@ -66,24 +80,72 @@ char* str_trim(char* dst, const char* src, const size_t len);
 int str_comp(const char* s1, const char* s2, const size_t len, int (*to)(const int));
 
 /**
- * Split string by delimeter to dynamic array of strings.
+ * Get view of string with leading and trailing whitespace chars removed.
  *
- * @param da Dynamic array to store split string.
- * @param src Input string.
+ * @param src Input string view.
+ * @returns View of input string without leading and trailing whitespace.
+ */
+struct str_view str_view_trim(const struct str_view src);
+
+/**
+ * Split string view by whitespace to dynamic array of string views.
+ * Existing values of dynamic array are replaced, allowing it to be reused without reallocating.
+ *
+ * @param da Dynamic array of str_view to store split string views.
+ * @param src Input string view.
+ * @returns Number of views stored in dynamic array. -1 if error.
+ */
+long long str_view_split(struct dynarr* da, const struct str_view src);
+
+/**
+ * Get number of leading chars in string which are whitespace, as defined by WHITESPACE.
+ *
+ * @param str Input string, does not need to be null-terminated.
  * @param len Max number of chars to look at.
- * @param delim Delimeter to split string by.
- * @returns Number of items pushed to dynamic array. -1 if error.
+ * @returns Number of leading whitespace chars.
  */
-long long str_split(struct dynarr* da, const char* src, const size_t len, const char* delim);
+size_t str_span_space(const char* str, const size_t len);
 
 /**
- * Return string as unsigned long long.
+ * Get number of leading chars in string which are not whitespace, as defined by WHITESPACE.
+ *
+ * @param str Input string, does not need to be null-terminated.
+ * @param len Max number of chars to look at.
+ * @returns Number of leading non-whitespace chars.
+ */
+size_t str_cspan_space(const char* str, const size_t len);
+
+/**
+ * Get number of leading chars in string which are alphanumeric chars (A-Z, a-z, 0-9), underscores (_), or periods (.).
+ *
+ * @param str Input string, does not need to be null-terminated.
+ * @param len Max number of chars to look at.
+ * @returns Number of leading alphanumeric, underscore, or period chars.
+ */
+size_t str_span_ident(const char* str, const size_t len);
+
+/**
+ * Return string as unsigned long long, converting each char using the given function.
  * Will only return first chars that can fit within return type,
  * i.e. will only return first 8 chars.
  *
  * @param str Input string.
- * @returns First 8 chars of string as unsigned long long.
+ * @param len Max number of chars to look at.
+ * @param to Function used to convert each char.
+ * @returns First 8 chars of converted string as unsigned long long.
+ */
+unsigned long long str_ull_to(const char* str, const size_t len, int (*to)(const int));
+
+/**
+ * Return string as unsigned long long, removing all chars using the given function.
+ * Will only return first chars that can fit within return type,
+ * i.e. will only return first 8 chars which are not removed.
+ *
+ * @param str Input string.
+ * @param len Max number of chars to look at.
+ * @param is Function used to test whether a char should be removed.
+ * @returns First 8 chars of string without removed chars as unsigned long long.
  */
-unsigned long long str_ull(const char* str);
+unsigned long long str_ull_rm(const char* str, const size_t len, int (*is)(const int));
 
 #endif
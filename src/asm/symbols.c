@@ -0,0 +1,142 @@
+#include "symbols.h"
+
+#include "str.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+
+#define SYMBOLS_CHARS_CAPACITY_INIT 0x100
+#define SYMBOLS_CAPACITY_INIT 16
+#define SYMBOLS_CAPACITY_INC(capacity) (capacity * 2)
+#define SYMBOLS_FULL(syms) ((syms.offsets.len + 1) * 2 > syms.capacity) // Keep load factor at most 1/2
+
+/**
+ * Calculate case-insensitive hash of key (FNV-1a).
+ */
+static size_t symbols_hash(const char* key, const size_t len)
+{
+	size_t hash = 2166136261u;
+
+	for (size_t ind = 0; ind < len; ind++) {
+		hash ^= (size_t)(unsigned char)tolower(key[ind]);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+/**
+ * Insert slot into symbol pool without resizing.
+ */
+static void symbols_insert(struct symbols* syms, const struct symbols_slot slot)
+{
+	size_t mask = syms->capacity - 1;
+	size_t slot_ind = slot.hash & mask;
+
+	// Linear probe for unused slot
+	while (syms->slots[slot_ind].sym != 0) {
+		slot_ind = (slot_ind + 1) & mask;
+	}
+
+	syms->slots[slot_ind] = slot;
+}
+
+/**
+ * Resize symbol pool, re-inserting all used slots.
+ */
+static bool symbols_resize(struct symbols* syms, const size_t capacity)
+{
+	struct symbols_slot* slots = (syms->arena) ? arena_alloc(syms->arena, capacity * sizeof(*slots)) : calloc(capacity, sizeof(*slots));
+	if (!slots)
+		return false;
+
+	struct symbols old = *syms;
+	syms->slots = slots;
+	syms->capacity = capacity;
+
+	for (size_t slot_ind = 0; slot_ind < old.capacity; slot_ind++) {
+		if (old.slots[slot_ind].sym != 0)
+			symbols_insert(syms, old.slots[slot_ind]);
+	}
+
+	if (old.slots && !old.arena) free(old.slots);
+	return true;
+}
+
+bool symbols_intern(struct symbols* syms, symbol_t* sym, const char* key, const size_t len)
+{
+	if (!syms || !sym || !key)
+		return false;
+
+	size_t hash = symbols_hash(key, len);
+
+	// Linear probe until matching key or unused slot found
+	if (syms->capacity > 0) {
+		size_t mask = syms->capacity - 1;
+		for (size_t slot_ind = hash & mask; syms->slots[slot_ind].sym != 0; slot_ind = (slot_ind + 1) & mask) {
+			struct symbols_slot slot = syms->slots[slot_ind];
+			if (slot.hash != hash)
+				continue;
+
+			const char* sym_key = symbols_key(*syms, slot.sym - 1);
+			if (str_comp(sym_key, key, len, tolower) == 0 && sym_key[len] == '\0') {
+				*sym = slot.sym - 1;
+				return true;
+			}
+		}
+	}
+
+	// Key not interned yet - validate symbol can be handed out
+	if (syms->offsets.len >= SYMBOLS_MAX)
+		return false;
+
+	// Increase capacity to keep probe sequences short
+	if (SYMBOLS_FULL((*syms)) && !symbols_resize(syms, (syms->capacity > 0) ? SYMBOLS_CAPACITY_INC(syms->capacity) : SYMBOLS_CAPACITY_INIT))
+		return false;
+
+	// Failure to pre-allocate space is non-critical - not checking return result
+	if (syms->chars.val_size == 0) {
+		syms->chars.arena = syms->arena;
+		syms->offsets.arena = syms->arena;
+		dynarr_alloc(&syms->chars, SYMBOLS_CHARS_CAPACITY_INIT, sizeof(char));
+	}
+
+	// Store key once, null-terminated
+	size_t offset = syms->chars.len;
+	const char nul = '\0';
+	if (len > 0 && !dynarr_set(&syms->chars, offset, key, len, sizeof(char)))
+		return false;
+
+	if (!dynarr_char_push(&syms->chars, nul) || !dynarr_size_push(&syms->offsets, offset)) {
+		syms->chars.len = offset;
+		return false;
+	}
+
+	struct symbols_slot slot = { .hash = hash, .sym = (symbol_t)syms->offsets.len };
+	symbols_insert(syms, slot);
+
+	*sym = slot.sym - 1;
+	return true;
+}
+
+const char* symbols_key(const struct symbols syms, const symbol_t sym)
+{
+	size_t* offset = dynarr_size_get(&syms.offsets, sym);
+	if (!offset)
+		return "";
+
+	char* key = dynarr_char_get(&syms.chars, *offset);
+	return (key) ? key : "";
+}
+
+void symbols_empty(struct symbols* syms)
+{
+	if (!syms)
+		return;
+
+	dynarr_empty(&syms->chars);
+	dynarr_empty(&syms->offsets);
+	if (syms->slots && !syms->arena) free(syms->slots);
+	syms->slots = NULL;
+	syms->capacity = 0;
+}
@@ -0,0 +1,69 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include "../arena.h"
+#include "../dynarr.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SYMBOLS_MAX (UINT32_MAX - 1)
+
+/**
+ * ID of interned symbol, compared instead of keys.
+ */
+typedef uint32_t symbol_t;
+
+DYNARR_DEFINE(symbol_t, symbol)
+
+/**
+ * Slot of symbol pool.
+ */
+struct symbols_slot {
+	size_t hash; // Case-insensitive hash of key
+	symbol_t sym; // Interned symbol + 1, 0 if slot is unused
+};
+
+/**
+ * Case-insensitive pool of interned keys.
+ * Each key is stored once, using the spelling it was first interned with.
+ */
+struct symbols {
+	struct dynarr chars; // Dynamic array of char, null-terminated keys
+	struct dynarr offsets; // Dynamic array of size_t, offset of each symbol's key in chars
+	struct symbols_slot* slots;
+	size_t capacity; // Number of slots, always a power of 2
+	struct arena* arena; // Arena to allocate keys and slots from, NULL to allocate them individually
+};
+
+/**
+ * Intern key, giving keys which only differ in case the same symbol.
+ *
+ * @param syms Symbol pool to intern key within.
+ * @param sym Symbol to store interned result.
+ * @param key Key to intern, does not need to be null-terminated.
+ * @param len Length of key to intern.
+ * @returns Whether key was interned successfully.
+ */
+bool symbols_intern(struct symbols* syms, symbol_t* sym, const char* key, const size_t len);
+
+/**
+ * Get key of interned symbol.
+ *
+ * @param syms Symbol pool symbol was interned within.
+ * @param sym Interned symbol.
+ * @returns Null-terminated key of symbol. Empty string if not found.
+ */
+const char* symbols_key(const struct symbols syms, const symbol_t sym);
+
+/**
+ * Free values within symbol pool.
+ * Symbol pool will be in unallocated state once values are freed.
+ * Values allocated from an arena are only freed with the arena.
+ *
+ * @param syms Symbol pool to free values of.
+ */
+void symbols_empty(struct symbols* syms);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef TOKENS_H
+#define TOKENS_H
+
+#include "../ngc.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Original NandGame assembler sets bits 14-16 of ALU instructions to 1 despite only bit 16 being relevant
+#define NGC_IN_ALU (NGC_IN_CI | (1 << 14) | (1 << 13))
+
+// Index of packed token within generated token table
+#define TOKENS_HASH(key, mult, shift) ((size_t)(((uint64_t)(key) * (uint64_t)(mult)) >> (shift)))
+
+/**
+ * Directive of non-instruction line.
+ */
+enum token_directive {
+	DIRECTIVE_NONE_E = -1,
+	DIRECTIVE_DEFINE_E,
+	DIRECTIVE_LABEL_E,
+	DIRECTIVE_MACRO_E,
+	DIRECTIVE_END_E
+};
+
+/**
+ * Decoded assembly token.
+ * Values are -1 where the token cannot be used in that part of a line.
+ */
+struct token_info {
+	unsigned long long key; // Token packed using str_ull_to() or str_ull_rm(), 0 if unused
+	long inst; // NGC instruction if the token is the only token of a line
+	long opr; // NGC ALU instruction bits indicating operation (bits 7-13)
+	long target; // NGC ALU instruction bit indicating target (bits 4-6)
+	long jump; // NGC ALU instruction bits indicating jump condition (bits 1-3)
+	enum token_directive directive; // Directive, only matched using uppercase token
+};
+
+#endif
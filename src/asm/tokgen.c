@@ -0,0 +1,170 @@
+/**
+ * Build-time generator of the assembly token table.
+ * Outputs a C header containing a perfect hash table of the tokens listed in tokens.def, decoded by parse.c.
+ */
+
+#include "tokens.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TOKGEN_TOKENS_MAX 0x100
+#define TOKGEN_HASH_BITS_MIN 6
+#define TOKGEN_HASH_BITS_MAX 12
+#define TOKGEN_HASH_TRIES 0x100000
+#define TOKGEN_TOKEN_LEN_MAX 7 // Shorter than packed tokens, so longer tokens truncated when packed never match
+
+/**
+ * Token listed in tokens.def.
+ */
+struct tokgen_def {
+	const char* str;
+	long inst;
+	long opr;
+	long target;
+	long jump;
+	enum token_directive directive;
+};
+
+static const struct tokgen_def tokgen_defs[] = {
+	#define TOKEN_INST(str, val) { str, val, -1, -1, -1, DIRECTIVE_NONE_E },
+	#define TOKEN_OPR(str, val) { str, -1, val, -1, -1, DIRECTIVE_NONE_E },
+	#define TOKEN_TARGET(str, val) { str, -1, -1, val, -1, DIRECTIVE_NONE_E },
+	#define TOKEN_JUMP(str, val) { str, -1, -1, -1, val, DIRECTIVE_NONE_E },
+	#define TOKEN_DIRECTIVE(str, val) { str, -1, -1, -1, -1, val },
+	#include "tokens.def"
+};
+
+#define TOKGEN_DEFS_LEN (sizeof(tokgen_defs) / sizeof(tokgen_defs[0]))
+
+/**
+ * Pack token the same way as str_ull_to() and str_ull_rm().
+ */
+static unsigned long long tokgen_pack(const char* str)
+{
+	unsigned long long result = 0;
+
+	for (size_t ind = 0; str[ind] != '\0'; ind++) {
+		result = (result << 8) | (unsigned char)str[ind];
+	}
+
+	return result;
+}
+
+/**
+ * Merge definition into token, failing if part of token is defined twice.
+ */
+static bool tokgen_merge(long* dst, const long src)
+{
+	if (src < 0)
+		return true;
+
+	if (*dst >= 0)
+		return false;
+
+	*dst = src;
+	return true;
+}
+
+/**
+ * Get next pseudo-random hash multiplier (xorshift64), always odd.
+ */
+static uint64_t tokgen_mult_next(uint64_t* state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state | 1;
+}
+
+int main(void)
+{
+	static struct token_info tokens[TOKGEN_TOKENS_MAX];
+	static bool slots_used[1 << TOKGEN_HASH_BITS_MAX];
+	size_t tokens_len = 0;
+
+	// Merge definitions of the same token
+	for (size_t def_ind = 0; def_ind < TOKGEN_DEFS_LEN; def_ind++) {
+		const struct tokgen_def def = tokgen_defs[def_ind];
+
+		if (strlen(def.str) < 1 || strlen(def.str) > TOKGEN_TOKEN_LEN_MAX) {
+			fprintf(stderr, "tokgen: Invalid token length: '%s'\n", def.str);
+			return 1;
+		}
+
+		unsigned long long key = tokgen_pack(def.str);
+		size_t token_ind = 0;
+		while (token_ind < tokens_len && tokens[token_ind].key != key) {
+			token_ind++;
+		}
+
+		if (token_ind == tokens_len) {
+			if (tokens_len >= TOKGEN_TOKENS_MAX) {
+				fprintf(stderr, "tokgen: Too many tokens (max %d)\n", TOKGEN_TOKENS_MAX);
+				return 1;
+			}
+
+			tokens[tokens_len++] = (struct token_info){ .key = key, .inst = -1, .opr = -1, .target = -1, .jump = -1, .directive = DIRECTIVE_NONE_E };
+		}
+
+		struct token_info* token = &tokens[token_ind];
+		long directive = token->directive;
+		if (!tokgen_merge(&token->inst, def.inst) || !tokgen_merge(&token->opr, def.opr) || !tokgen_merge(&token->target, def.target) || !tokgen_merge(&token->jump, def.jump) || !tokgen_merge(&directive, def.directive)) {
+			fprintf(stderr, "tokgen: Token defined twice: '%s'\n", def.str);
+			return 1;
+		}
+
+		token->directive = (enum token_directive)directive;
+	}
+
+	// Find smallest table and multiplier which gives each token its own slot
+	for (unsigned int bits = TOKGEN_HASH_BITS_MIN; bits <= TOKGEN_HASH_BITS_MAX; bits++) {
+		size_t slots_len = (size_t)1 << bits;
+		if (tokens_len * 2 > slots_len)
+			continue;
+
+		unsigned int shift = 64 - bits;
+		uint64_t state = 0x9E3779B97F4A7C15u;
+
+		for (size_t try = 0; try < TOKGEN_HASH_TRIES; try++) {
+			uint64_t mult = tokgen_mult_next(&state);
+			bool perfect = true;
+			memset(slots_used, 0, sizeof(slots_used));
+
+			for (size_t token_ind = 0; token_ind < tokens_len && perfect; token_ind++) {
+				size_t slot = TOKENS_HASH(tokens[token_ind].key, mult, shift);
+				perfect = !slots_used[slot];
+				slots_used[slot] = true;
+			}
+
+			if (!perfect)
+				continue;
+
+			// Output table
+			printf("// Generated by tokgen.c from tokens.def - do not edit\n\n");
+			printf("#ifndef TOKENS_TABLE_H\n#define TOKENS_TABLE_H\n\n// Requires tokens.h to be included first\n\n");
+			printf("#define TOKENS_TABLE_MULT UINT64_C(0x%016" PRIX64 ")\n", mult);
+			printf("#define TOKENS_TABLE_SHIFT %u\n", shift);
+			printf("#define TOKENS_TABLE_LEN %zu\n\n", slots_len);
+			printf("static const struct token_info tokens_table[TOKENS_TABLE_LEN] = {\n");
+
+			for (size_t slot = 0; slot < slots_len; slot++) {
+				struct token_info token = { .key = 0, .inst = -1, .opr = -1, .target = -1, .jump = -1, .directive = DIRECTIVE_NONE_E };
+				for (size_t token_ind = 0; token_ind < tokens_len; token_ind++) {
+					if (TOKENS_HASH(tokens[token_ind].key, mult, shift) == slot)
+						token = tokens[token_ind];
+				}
+
+				printf("\t{ 0x%llX, %ld, %ld, %ld, %ld, %d },\n", token.key, token.inst, token.opr, token.target, token.jump, (int)token.directive);
+			}
+
+			printf("};\n\n#endif\n");
+			return 0;
+		}
+	}
+
+	fprintf(stderr, "tokgen: No perfect hash found for %zu tokens\n", tokens_len);
+	return 1;
+}
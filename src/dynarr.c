@@ -20,7 +20,7 @@ size_t dynarr_alloc(struct dynarr* da, const size_t capacity, const size_t val_s
 	if (!da)
 		return 0;
 
-	da->vals = calloc(capacity, val_size);
+	da->vals = (da->arena) ? arena_alloc(da->arena, capacity * val_size) : calloc(capacity, val_size);
 	da->val_size = val_size;
 	da->len = 0;
 
@@ -48,6 +48,17 @@ static size_t dynarr_realloc(struct dynarr* da, size_t capacity)
 	if (capacity <= da->capacity)
 		return da->capacity * da->val_size;
 
+	// Memory allocated from arena is already zeroed
+	if (da->arena) {
+		void* vals_new = arena_realloc(da->arena, da->vals, da->capacity * da->val_size, capacity * da->val_size);
+		if (!vals_new)
+			return 0;
+
+		da->vals = vals_new;
+		da->capacity = capacity;
+		return da->capacity * da->val_size;
+	}
+
 	void* vals_new = realloc(da->vals, capacity * da->val_size);
 	if (!vals_new)
 		return 0;
@@ -61,6 +72,33 @@ static size_t dynarr_realloc(struct dynarr* da, size_t capacity)
 	return da->capacity * da->val_size;
 }
 
+size_t dynarr_reserve(struct dynarr* da, const size_t capacity, const size_t val_size)
+{
+	if (!da)
+		return 0;
+
+	// Allocate space for all values if not allocated already
+	if (!da->vals) {
+		size_t capacity_new = 1;
+		while (capacity > capacity_new) {
+			capacity_new = CAPACITY_INC(capacity_new);
+		}
+
+		return dynarr_alloc(da, capacity_new, val_size);
+	}
+
+	if (val_size != da->val_size)
+		return 0;
+
+	// Increase capacity to fit all values if not enough
+	size_t capacity_new = (da->capacity > 0) ? da->capacity : 1;
+	while (capacity > capacity_new) {
+		capacity_new = CAPACITY_INC(capacity_new);
+	}
+
+	return dynarr_realloc(da, capacity_new);
+}
+
 void* dynarr_push(struct dynarr* da, const void* val, const size_t size)
 {
 	if (!da || !val)
@@ -100,33 +138,11 @@ void* dynarr_set(struct dynarr* da, const size_t ind, const void* vals, const si
 	bool da_unalloc = !da->vals;
 	size_t len_new = (ind + vals_len > da->len) ? ind + vals_len : da->len;
 
-	// Allocate space for all values if not allocated already
-	if (da_unalloc) {
-		size_t capacity = 1;
-		while (len_new > capacity) {
-			capacity = CAPACITY_INC(capacity);
-		}
-
-		if (dynarr_alloc(da, capacity, val_size) == 0)
-			goto error;
-	}
-
-	if (val_size != da->val_size)
+	// Allocate space for all values, or increase capacity to fit all values if not enough
+	// If failure happens after realloc, dynamic array will not be shrunk
+	if (dynarr_reserve(da, len_new, val_size) == 0)
 		goto error;
 
-	// Increase capacity to fit all values if not enough
-	if (len_new > da->capacity) {
-		size_t capacity_new = da->capacity;
-		do {
-			capacity_new = CAPACITY_INC(capacity_new);
-		} while (len_new > capacity_new);
-
-		if (dynarr_realloc(da, capacity_new) == 0)
-			goto error;
-
-		// If failure happens after realloc, dynamic array will not be shrunk
-	}
-
 	void* result = memcpy((uint8_t*)da->vals + (ind * da->val_size), vals, vals_len * val_size);
 	if (!result)
 		goto error;
@@ -156,7 +172,7 @@ void dynarr_empty(struct dynarr* da)
 	if (!da)
 		return;
 
-	if (da->vals) free(da->vals);
+	if (da->vals && !da->arena) free(da->vals);
 	da->vals = NULL;
 	da->val_size = 0;
 	da->len = 0;
@@ -1,7 +1,10 @@
 #ifndef DYNARR_H
 #define DYNARR_H
 
+#include "arena.h"
+
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * Dynamic array.
@@ -11,6 +14,7 @@ struct dynarr {
 	size_t val_size;
 	size_t capacity;
 	size_t len;
+	struct arena* arena; // Arena to allocate values from, NULL to allocate values individually
 };
 
 /**
@@ -32,6 +36,17 @@ void* dynarr_get(const struct dynarr da, const size_t ind);
  */
 size_t dynarr_alloc(struct dynarr* da, const size_t capacity, const size_t val_size);
 
+/**
+ * Reserve space for dynamic array to fit number of values, growing its capacity geometrically so repeated reserves are amortised.
+ * If dynamic array is unallocated, size of values given will become the enforced maximum size of values for the dynamic array.
+ *
+ * @param da Dynamic array to reserve space for.
+ * @param capacity Number of values to fit.
+ * @param val_size Size of values, which must match the enforced maximum size of values if dynamic array is allocated.
+ * @returns Number of bytes allocated for dynamic array. 0 if error.
+ */
+size_t dynarr_reserve(struct dynarr* da, const size_t capacity, const size_t val_size);
+
 /**
  * Push copy of value to end of dynamic array.
  * Size of value to copy can be less than the enforced maximum size of values for the dynamic array. In this case the copied value will be null-terminated.
@@ -61,6 +76,7 @@ void* dynarr_set(struct dynarr* da, const size_t ind, const void* vals, const si
 /**
  * Free values within dynamic array using delegate function.
  * Dynamic array will be in unallocated state once values are freed.
+ * Values allocated from an arena are only freed with the arena.
  *
  * @param da Dynamic array to free values of.
  * @param f Delegate function used to empty values.
@@ -70,9 +86,39 @@ void dynarr_delegate_empty(struct dynarr* da, void (*f)(void*));
 /**
  * Free values within dynamic array.
  * Dynamic array will be in unallocated state once values are freed.
+ * Values allocated from an arena are only freed with the arena.
  *
  * @param da Dynamic array to free values of.
  */
 void dynarr_empty(struct dynarr* da);
 
+/**
+ * Define inline functions to get and push values of dynamic arrays of a single type, named dynarr_<name>_get() and dynarr_<name>_push().
+ * Size of values is known at compile time, avoiding the runtime size and copy of dynarr_get() and dynarr_push().
+ * Dynamic arrays of a single type are accessed through these functions, defined alongside the type of their values.
+ * Values pushed are only copied in place if the dynamic array was allocated with the same size of values.
+ *
+ * @param type Type of values of dynamic array.
+ * @param name Name of functions.
+ */
+#define DYNARR_DEFINE(type, name) \
+	static inline type* dynarr_##name##_get(const struct dynarr* da, const size_t ind) \
+	{ \
+		return (ind < da->len) ? (type*)da->vals + ind : NULL; \
+	} \
+	\
+	static inline type* dynarr_##name##_push(struct dynarr* da, const type val) \
+	{ \
+		if ((da->len >= da->capacity || da->val_size != sizeof(type)) && dynarr_reserve(da, da->len + 1, sizeof(type)) == 0) \
+			return NULL; \
+		\
+		type* result = (type*)da->vals + da->len++; \
+		*result = val; \
+		return result; \
+	}
+
+DYNARR_DEFINE(uint8_t, byte)
+DYNARR_DEFINE(char, char)
+DYNARR_DEFINE(size_t, size)
+
 #endif
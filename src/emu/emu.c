@@ -1,30 +1,145 @@
 #include "emu.h"
 
-#define NGC_RAM_ALLOC_LEN 512
-#define NGC_ROM_ALLOC_LEN 32
+#include <stdlib.h>
+#include <string.h>
 
-#define NGC_RXM_ALLOC(rxm, capacity) dynarr_alloc(rxm, capacity, sizeof(ngc_word_t))
+#define NGC_PAGE_DIRTY(mem, page) (mem->ram_dirty[page / 8] & (1 << (page % 8)))
+#define NGC_PAGE_DIRTY_SET(mem, page) (mem->ram_dirty[page / 8] |= (uint8_t)(1 << (page % 8)))
 
-ngc_word_t ngc_rxm_get(const struct dynarr rxm, const ngc_uword_t addr)
+/**
+ * Get page of RAM owned only by the given memory, allocating or copying a page if required.
+ *
+ * @param mem NandGame computer memory.
+ * @param page_ind Index of page to get.
+ * @returns Page owned by memory. NULL if error.
+ */
+static struct ngc_page* ngc_page_own(struct ngc_mem* mem, const size_t page_ind)
+{
+	struct ngc_page* page = mem->ram[page_ind];
+	if (page && page->refs == 1)
+		return page;
+
+	// Copy shared page, or allocate zeroed page if not written to yet
+	struct ngc_page* page_new = page ? malloc(sizeof(*page_new)) : calloc(1, sizeof(*page_new));
+	if (!page_new)
+		return NULL;
+
+	if (page) {
+		memcpy(page_new->words, page->words, sizeof(page_new->words));
+		page->refs--;
+	}
+
+	page_new->refs = 1;
+	mem->ram[page_ind] = page_new;
+	return page_new;
+}
+
+/**
+ * Release page of RAM, freeing it if no other memory references it.
+ *
+ * @param mem NandGame computer memory.
+ * @param page_ind Index of page to release.
+ */
+static void ngc_page_release(struct ngc_mem* mem, const size_t page_ind)
+{
+	struct ngc_page* page = mem->ram[page_ind];
+	if (!page)
+		return;
+
+	if (--page->refs == 0)
+		free(page);
+
+	mem->ram[page_ind] = NULL;
+}
+
+/**
+ * Release ROM, freeing it if no other memory references it.
+ *
+ * @param mem NandGame computer memory.
+ */
+static void ngc_rom_release(struct ngc_mem* mem)
 {
-	ngc_word_t* val = dynarr_get(rxm, (size_t)addr);
-	return (val) ? *val : 0;
+	if (!mem->rom)
+		return;
+
+	if (--mem->rom->refs == 0)
+		free(mem->rom);
+
+	mem->rom = NULL;
 }
 
-ngc_word_t* ngc_rxm_set(struct dynarr* rxm, const ngc_uword_t addr, const ngc_word_t* words, const size_t len)
+bool ngc_ram_set(struct ngc_mem* mem, const ngc_uword_t addr, const ngc_word_t* words, const size_t len)
 {
-	// Ensure length of dynamic array does not exceed max RAM/ROM size
+	if (!mem || !words || len == 0)
+		return false;
+
+	// Ensure values do not exceed max RAM size
 	if ((size_t)addr + len > NGC_RXM_LEN + 1)
-		return NULL;
+		return false;
 
-	return dynarr_set(rxm, (size_t)addr, words, len, sizeof(ngc_word_t));
+	// Copy values one page at a time
+	for (size_t ind = 0; ind < len;) {
+		size_t ram_addr = (size_t)addr + ind;
+		size_t page_ind = ram_addr / NGC_RAM_PAGE_LEN;
+		size_t page_offset = ram_addr % NGC_RAM_PAGE_LEN;
+		size_t page_len = (NGC_RAM_PAGE_LEN - page_offset < len - ind) ? NGC_RAM_PAGE_LEN - page_offset : len - ind;
+
+		struct ngc_page* page = ngc_page_own(mem, page_ind);
+		if (!page)
+			return false;
+
+		memcpy(&page->words[page_offset], &words[ind], page_len * sizeof(ngc_word_t));
+		NGC_PAGE_DIRTY_SET(mem, page_ind);
+
+		ind += page_len;
+	}
+
+	return true;
+}
+
+bool ngc_rom_set(struct ngc_mem* mem, const ngc_word_t* words, const size_t len)
+{
+	if (!mem || !words || len == 0)
+		return false;
+
+	// Ensure values do not exceed max ROM size
+	if (len > NGC_RXM_LEN + 1)
+		return false;
+
+	struct ngc_rom* rom = malloc(sizeof(*rom) + (len * sizeof(ngc_word_t)));
+	if (!rom)
+		return false;
+
+	rom->refs = 1;
+	rom->len = len;
+	memcpy(rom->words, words, len * sizeof(ngc_word_t));
+
+	ngc_rom_release(mem);
+	mem->rom = rom;
+	return true;
 }
 
-void ngc_mem_alloc(struct ngc_mem* mem)
+void ngc_mem_share(struct ngc_mem* dst, const struct ngc_mem* src)
 {
-	// Failure to pre-allocate space is non-critical - not checking return results
-	NGC_RXM_ALLOC(&mem->ram, NGC_RAM_ALLOC_LEN);
-	NGC_RXM_ALLOC(&mem->rom, NGC_ROM_ALLOC_LEN);
+	if (!dst || !src)
+		return;
+
+	dst->a = src->a;
+	dst->d = src->d;
+	dst->pc = src->pc;
+
+	for (size_t page_ind = 0; page_ind < NGC_RAM_PAGES; page_ind++) {
+		dst->ram[page_ind] = src->ram[page_ind];
+		if (!dst->ram[page_ind])
+			continue;
+
+		dst->ram[page_ind]->refs++;
+		NGC_PAGE_DIRTY_SET(dst, page_ind);
+	}
+
+	dst->rom = src->rom;
+	if (dst->rom)
+		dst->rom->refs++;
 }
 
 void ngc_mem_empty(struct ngc_mem* mem)
@@ -35,8 +150,13 @@ void ngc_mem_empty(struct ngc_mem* mem)
 	mem->a = 0;
 	mem->d = 0;
 	mem->pc = 0;
-	dynarr_empty(&mem->ram);
-	dynarr_empty(&mem->rom);
+
+	for (size_t page_ind = 0; page_ind < NGC_RAM_PAGES; page_ind++) {
+		ngc_page_release(mem, page_ind);
+	}
+
+	ngc_rom_release(mem);
+	memset(mem->ram_dirty, 0, sizeof(mem->ram_dirty));
 }
 
 void ngc_mem_reset(struct ngc_mem* mem)
@@ -47,10 +167,19 @@ void ngc_mem_reset(struct ngc_mem* mem)
 	mem->a = 0;
 	mem->d = 0;
 	mem->pc = 0;
-	dynarr_empty(&mem->ram);
 
-	// Failure to pre-allocate space is non-critical - not checking return results
-	NGC_RXM_ALLOC(&mem->ram, NGC_RAM_ALLOC_LEN);
+	// Clear only pages which may be non-zero - owned pages keep their allocated space
+	for (size_t page_ind = 0; page_ind < NGC_RAM_PAGES; page_ind++) {
+		if (!NGC_PAGE_DIRTY(mem, page_ind) || !mem->ram[page_ind])
+			continue;
+
+		if (mem->ram[page_ind]->refs > 1)
+			ngc_page_release(mem, page_ind);
+		else
+			memset(mem->ram[page_ind]->words, 0, sizeof(mem->ram[page_ind]->words));
+	}
+
+	memset(mem->ram_dirty, 0, sizeof(mem->ram_dirty));
 }
 
 /**
@@ -129,40 +258,40 @@ static bool ngc_jump_calc(const ngc_word_t inst, const ngc_word_t alu)
 	}
 }
 
-void ngc_tick_calc(struct ngc_tick* tick, const struct ngc_mem mem)
+void ngc_tick_calc(struct ngc_tick* tick, const struct ngc_mem* mem)
 {
-	if (!tick)
+	if (!tick || !mem)
 		return;
 
-	ngc_word_t inst = ngc_rxm_get(mem.rom, mem.pc);
-	ngc_word_t mem_aa = ngc_rxm_get(mem.ram, (ngc_uword_t)mem.a);
+	ngc_word_t inst = ngc_rom_get(mem, mem->pc);
+	ngc_word_t mem_aa = ngc_ram_get(mem, (ngc_uword_t)mem->a);
 
 	// Set input values
 	tick->inst = inst;
-	tick->in.a = mem.a;
-	tick->in.d = mem.d;
-	tick->in.pc = mem.pc;
+	tick->in.a = mem->a;
+	tick->in.d = mem->d;
+	tick->in.pc = mem->pc;
 	tick->in.aa = mem_aa;
 
 	// Instruction is ALU instruction
 	if (inst & NGC_IN_CI) {
-		ngc_word_t alu = ngc_alu_calc(inst, mem.a, mem.d, mem_aa);
+		ngc_word_t alu = ngc_alu_calc(inst, mem->a, mem->d, mem_aa);
 		tick->alu = alu;
 
 		// Memory is set to ALU output if instruction targets it
-		tick->out.a = (inst & NGC_IN_TARGET_A) ? alu : mem.a;
-		tick->out.d = (inst & NGC_IN_TARGET_D) ? alu : mem.d;
+		tick->out.a = (inst & NGC_IN_TARGET_A) ? alu : mem->a;
+		tick->out.d = (inst & NGC_IN_TARGET_D) ? alu : mem->d;
 		tick->out.aa = (inst & NGC_IN_TARGET_AA) ? alu : mem_aa;
 
 		// Program counter is set to A register output if ALU output meets jump conditions
-		tick->out.pc = ngc_jump_calc(inst, alu) ? tick->out.a : mem.pc + 1;
+		tick->out.pc = ngc_jump_calc(inst, alu) ? tick->out.a : mem->pc + 1;
 	// Instruction is data instruction
 	} else {
 		tick->alu = 0;
 		tick->out.a = inst;
-		tick->out.d = mem.d;
+		tick->out.d = mem->d;
 		tick->out.aa = mem_aa;
-		tick->out.pc = mem.pc + 1;
+		tick->out.pc = mem->pc + 1;
 	}
 }
 
@@ -175,7 +304,7 @@ bool ngc_tick_set(struct ngc_mem* mem, const struct ngc_tick tick)
 	mem->d = tick.out.d;
 	mem->pc = tick.out.pc;
 
-	if (tick.in.aa != tick.out.aa && !ngc_rxm_set(&mem->ram, (ngc_uword_t)tick.in.a, &tick.out.aa, 1))
+	if (tick.in.aa != tick.out.aa && !ngc_ram_set(mem, (ngc_uword_t)tick.in.a, &tick.out.aa, 1))
 		return false;
 
 	return true;
@@ -1,23 +1,49 @@
 #ifndef EMU_H
 #define EMU_H
 
-#include "../dynarr.h"
 #include "../ngc.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #define NGC_RXM_LEN NGC_UWORD_MAX
 #define NGC_RXM_SIZE (NGC_RXM_LEN * sizeof(ngc_word_t))
 
+#define NGC_RAM_PAGE_LEN 0x100
+#define NGC_RAM_PAGES ((NGC_RXM_LEN + 1) / NGC_RAM_PAGE_LEN)
+
+/**
+ * Page of NandGame computer RAM.
+ * Pages can be shared between NandGame computer memory instances, and are copied on first write when shared.
+ */
+struct ngc_page {
+	size_t refs; // Number of memory instances referencing page, not atomic
+	ngc_word_t words[NGC_RAM_PAGE_LEN];
+};
+
+/**
+ * NandGame computer ROM.
+ * ROM is shared between NandGame computer memory instances, and is never written to once set.
+ */
+struct ngc_rom {
+	size_t refs; // Number of memory instances referencing ROM, not atomic
+	size_t len;
+	ngc_word_t words[];
+};
+
 /**
  * NandGame computer memory.
+ * Zero-initialised memory is in unallocated state.
+ * Memory instances sharing pages or ROM are owned by a single thread - see ngc_mem_share().
  */
 struct ngc_mem {
 	ngc_word_t a;
 	ngc_word_t d;
 	ngc_uword_t pc;
-	struct dynarr ram; // Dynamic array of ngc_word_t
-	struct dynarr rom; // Dynamic array of ngc_word_t
+	struct ngc_page* ram[NGC_RAM_PAGES]; // NULL if page has not been written to
+	struct ngc_rom* rom; // NULL if ROM has not been set
+	uint8_t ram_dirty[NGC_RAM_PAGES / 8]; // Bitmap of RAM pages which may be non-zero
 };
 
 /**
@@ -42,31 +68,74 @@ struct ngc_tick
 };
 
 /**
- * Get value at address from RAM/ROM in NandGame computer memory.
+ * Get value at address from RAM in NandGame computer memory.
  *
- * @param rxm RAM/ROM to get value from.
+ * @param mem NandGame computer memory to get value from.
  * @param addr Address of value to get.
  * @returns Value at address.
  */
-ngc_word_t ngc_rxm_get(const struct dynarr rxm, const ngc_uword_t addr);
+static inline ngc_word_t ngc_ram_get(const struct ngc_mem* mem, const ngc_uword_t addr)
+{
+	struct ngc_page* page = mem->ram[addr / NGC_RAM_PAGE_LEN];
+	return (page) ? page->words[addr % NGC_RAM_PAGE_LEN] : 0;
+}
+
+/**
+ * Get value at address from ROM in NandGame computer memory.
+ *
+ * @param mem NandGame computer memory to get value from.
+ * @param addr Address of value to get.
+ * @returns Value at address.
+ */
+static inline ngc_word_t ngc_rom_get(const struct ngc_mem* mem, const ngc_uword_t addr)
+{
+	return (mem->rom && addr < mem->rom->len) ? mem->rom->words[addr] : 0;
+}
+
+/**
+ * Get number of values in ROM in NandGame computer memory.
+ *
+ * @param mem NandGame computer memory.
+ * @returns Number of values in ROM.
+ */
+static inline size_t ngc_rom_len(const struct ngc_mem* mem)
+{
+	return (mem->rom) ? mem->rom->len : 0;
+}
+
+/**
+ * Set values of RAM in NandGame computer memory to copy of values given.
+ * Pages shared with other memory instances are copied before being written to.
+ *
+ * @param mem NandGame computer memory to set RAM values of.
+ * @param addr Address of RAM to set values from.
+ * @param words Pointer to values to copy.
+ * @param len Number of values to copy.
+ * @returns Whether values were copied to RAM.
+ */
+bool ngc_ram_set(struct ngc_mem* mem, const ngc_uword_t addr, const ngc_word_t* words, const size_t len);
 
 /**
- * Set values of RAM/ROM in NandGame computer memory to copy of values given.
+ * Set ROM in NandGame computer memory to copy of values given.
+ * Any ROM previously set is released.
  *
- * @param rxm RAM/ROM to set values of.
- * @param addr Address of RAM/ROM to set values from.
+ * @param mem NandGame computer memory to set ROM of.
  * @param words Pointer to values to copy.
  * @param len Number of values to copy.
- * @returns Values copied to RAM/ROM. NULL if error.
+ * @returns Whether values were copied to ROM.
  */
-ngc_word_t* ngc_rxm_set(struct dynarr* rxm, const ngc_uword_t addr, const ngc_word_t* words, const size_t len);
+bool ngc_rom_set(struct ngc_mem* mem, const ngc_word_t* words, const size_t len);
 
 /**
- * Pre-allocate initial space for NandGame computer memory.
+ * Initialise NandGame computer memory to share RAM pages and ROM of another.
+ * Shared RAM pages are copied on first write by either memory.
+ * Reference counts of shared pages and ROM are not atomic, so all memory sharing them must be written to, reset and freed from the same thread.
+ * Memory run on other threads must be given its own copy with ngc_ram_set() and ngc_rom_set() instead.
  *
- * @param mem NandGame computer memory to pre-allocate space for.
+ * @param dst Unallocated NandGame computer memory to initialise.
+ * @param src NandGame computer memory to share.
  */
-void ngc_mem_alloc(struct ngc_mem* mem);
+void ngc_mem_share(struct ngc_mem* dst, const struct ngc_mem* src);
 
 /**
  * Free values within NandGame computer memory.
@@ -78,6 +147,7 @@ void ngc_mem_empty(struct ngc_mem* mem);
 
 /**
  * Initialize volatile NandGame computer memory to default state, preserve ROM.
+ * Pages owned by memory are kept and cleared only if written to, pages shared with other memory are released.
  *
  * @param mem NandGame computer memory to reset.
  */
@@ -89,7 +159,7 @@ void ngc_mem_reset(struct ngc_mem* mem);
  * @param tick Result of NandGame computer processor tick.
  * @param mem NandGame computer memory.
  */
-void ngc_tick_calc(struct ngc_tick* tick, const struct ngc_mem mem);
+void ngc_tick_calc(struct ngc_tick* tick, const struct ngc_mem* mem);
 
 /**
  * Set NandGame computer memory to result of calculated processor tick.
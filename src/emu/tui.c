@@ -34,6 +34,10 @@
 #define CLOCK_HZ_MAX 10000
 #define CLOCK_HZ_MULTI 10
 
+#define RUN_TO_TICKS_PER_EPOCH 0x1000 // Number of ticks between checking the time when running to address
+
+#define PROMPT_LEN_MAX 16
+
 #define WIN_ROW_GAP 0
 #define WIN_COL_GAP 1
 #define WIN_ROW_PADDING 1
@@ -54,22 +58,26 @@
 #define WIN_REG_ROWS WIN_ROWS(3)
 #define WIN_INTR_Y (WIN_REG_Y + WIN_REG_ROWS + WIN_ROW_GAP)
 #define WIN_INTR_ROWS WIN_ROWS(2)
+#define WIN_PERF_Y (WIN_INTR_Y + WIN_INTR_ROWS + WIN_ROW_GAP)
+#define WIN_PERF_ROWS WIN_ROWS(5)
 #define WIN_RAM_Y 0
-#define WIN_RAM_ROWS WIN_ROWS(WIN_RAM_LINES)
 #define WIN_ROM_Y 0
-#define WIN_ROM_ROWS WIN_ROWS(WIN_ROM_LINES)
+#define WIN_MEM_ROWS(term_rows) MAX(term_rows, WINS_TOTAL_ROWS) // RAM and ROM windows fill height of terminal
+#define WIN_MEM_LINES_MIN 11
+
+#define WIN_GROUP_1_ROWS (WIN_PERF_Y + WIN_PERF_ROWS)
 
-#define WINS_TOTAL_ROWS WIN_RAM_ROWS
+#define WINS_TOTAL_ROWS MAX(WIN_GROUP_1_ROWS, WIN_ROWS(WIN_MEM_LINES_MIN))
 #define WINS_TOTAL_COLS (WIN_GROUP_1_COLS + WIN_COL_GAP + WIN_GROUP_2_COLS + WIN_COL_GAP + WIN_GROUP_3_COLS)
 
-#define WINS_OFFSET_Y(rows) ((rows > WINS_TOTAL_ROWS) ? (rows - WINS_TOTAL_ROWS) / 2 : 0)
 #define WINS_OFFSET_X(cols) ((cols > WINS_TOTAL_COLS) ? (cols - WINS_TOTAL_COLS) / 2 : 0)
 
-#define WIN_RAM_LINES 11
-#define WIN_ROM_LINES 11
-
 #define MEM_ADDR_INIT(addr, lines) ((addr / lines) * lines)
 
+#define PERF_JITTER_SAMPLES 256
+
+#define MAX(a, b) ((a > b) ? a : b)
+
 enum exit_val {
 	SUCCESS_E,
 	FAILURE_E,
@@ -88,6 +96,7 @@ struct display_wins {
 	WINDOW* clock;
 	WINDOW* registers;
 	WINDOW* internal;
+	WINDOW* perf;
 	WINDOW* ram;
 	WINDOW* rom;
 };
@@ -95,9 +104,43 @@ struct display_wins {
 struct ngc_clock {
 	bool enabled;
 	bool disable_on_complete;
+	bool run_to; // Tick at maximum speed until PC reaches run_to_pc
+	ngc_uword_t run_to_pc;
 	unsigned short hz;
 };
 
+enum mem_view_focus {
+	VIEW_RAM_E,
+	VIEW_ROM_E
+};
+
+struct mem_view {
+	bool pinned; // Whether view is pinned to cursor, rather than following the A/PC register
+	size_t cursor; // Address view is pinned to
+	size_t top; // Address at top of view
+};
+
+struct mem_views {
+	enum mem_view_focus focus;
+	struct mem_view ram;
+	struct mem_view rom;
+};
+
+struct perf_stats {
+	long long period_epoch_us; // Start of current tick rate sample period
+	long long period_ticks; // Number of ticks within current sample period
+	long long ticks_per_sec; // Tick rate achieved in last sample period
+	long long tick_epoch_us; // Time of last timed tick. 0 if next tick cannot be timed
+	long long jitter_us[PERF_JITTER_SAMPLES]; // Ring buffer of tick interval deviations
+	size_t jitter_len;
+	size_t jitter_ind;
+	long long jitter_p50_us;
+	long long jitter_p99_us;
+	long long draw_us; // Time taken to draw last frame
+	long long in_epoch_us; // Time of last keyboard input not yet drawn. 0 if none
+	long long in_latency_us; // Time between last keyboard input and drawing of its result
+};
+
 static long long get_epoch_us(void)
 {
 	struct timespec time;
@@ -117,6 +160,70 @@ static void sleep_us(const long long us)
 	nanosleep(&time, NULL);
 }
 
+static int comp_ll(const void* p1, const void* p2)
+{
+	long long ll1 = *(const long long*)p1;
+	long long ll2 = *(const long long*)p2;
+	return (ll1 > ll2) - (ll1 < ll2);
+}
+
+/**
+ * Record processor tick in performance stats.
+ */
+static void perf_tick(struct perf_stats* perf, const long long epoch_us, const long long us_per_tick)
+{
+	perf->period_ticks++;
+
+	// Record deviation of interval between timed ticks from the expected interval
+	if (perf->tick_epoch_us > 0) {
+		long long jitter_us = (epoch_us - perf->tick_epoch_us) - us_per_tick;
+		perf->jitter_us[perf->jitter_ind] = (jitter_us < 0) ? -jitter_us : jitter_us;
+		perf->jitter_ind = (perf->jitter_ind + 1) % PERF_JITTER_SAMPLES;
+
+		if (perf->jitter_len < PERF_JITTER_SAMPLES)
+			perf->jitter_len++;
+	}
+
+	perf->tick_epoch_us = epoch_us;
+}
+
+/**
+ * Prevent next processor tick from being timed against the last.
+ * Used when the interval between ticks is not determined by the clock, e.g. paused, stepped, reset.
+ */
+static inline void perf_tick_break(struct perf_stats* perf)
+{
+	perf->tick_epoch_us = 0;
+}
+
+/**
+ * Calculate performance stats from recorded samples.
+ */
+static void perf_calc(struct perf_stats* perf, const long long epoch_us)
+{
+	// Calculate tick rate once sample period has elapsed
+	long long period_us = epoch_us - perf->period_epoch_us;
+	if (period_us >= US_PER_SEC) {
+		perf->ticks_per_sec = (perf->period_ticks * US_PER_SEC) / period_us;
+		perf->period_ticks = 0;
+		perf->period_epoch_us = epoch_us;
+	}
+
+	if (perf->jitter_len == 0) {
+		perf->jitter_p50_us = 0;
+		perf->jitter_p99_us = 0;
+		return;
+	}
+
+	// Sort copy of samples to get percentiles
+	long long jitter_sorted[PERF_JITTER_SAMPLES];
+	memcpy(jitter_sorted, perf->jitter_us, perf->jitter_len * sizeof(jitter_sorted[0]));
+	qsort(jitter_sorted, perf->jitter_len, sizeof(jitter_sorted[0]), comp_ll);
+
+	perf->jitter_p50_us = jitter_sorted[(perf->jitter_len * 50) / 100];
+	perf->jitter_p99_us = jitter_sorted[(perf->jitter_len * 99) / 100];
+}
+
 static bool term_init(struct term* term, const char in_path[])
 {
 	if (!term)
@@ -197,6 +304,28 @@ static inline void term_clear(const struct term* term)
 	wrefresh(term->win);
 }
 
+/**
+ * Read line of keyboard input from bottom row of terminal, blocking until entered.
+ */
+static bool term_prompt(const struct term* term, const char prompt[], char* buf, const int len)
+{
+	mvwprintw(term->win, term->rows - 1, 0, "%s", prompt);
+	wclrtoeol(term->win);
+
+	echo();
+	nodelay(term->win, FALSE);
+	curs_set(1);
+
+	bool result = wgetnstr(term->win, buf, len) != ERR;
+
+	noecho();
+	nodelay(term->win, TRUE);
+	curs_set(0);
+
+	term_clear(term);
+	return result;
+}
+
 static void term_free(struct term* term)
 {
 	endwin();
@@ -214,19 +343,33 @@ static void window_update_start(WINDOW* win)
 	wmove(win, WIN_ROW_PADDING, WIN_COL_PADDING);
 }
 
-static void window_update_finish(WINDOW* win, const char label[])
+static void window_update_finish_attr(WINDOW* win, const char label[], const int attr)
 {
-	// Draw dim box + label around window
-	wattron(win, A_DIM);
+	// Draw box + label around window
+	wattron(win, attr);
 	box(win, 0, 0);
 	wmove(win, 0, 1);
 	wprintw(win, " %s ", label);
-	wattroff(win, A_DIM);
+	wattroff(win, attr);
 
 	wnoutrefresh(win);
 	doupdate();
 }
 
+static inline void window_update_finish(WINDOW* win, const char label[])
+{
+	window_update_finish_attr(win, label, A_DIM);
+}
+
+/**
+ * Get number of lines within window that can be printed to.
+ */
+static inline size_t window_lines(WINDOW* win)
+{
+	int rows = getmaxy(win) - (WIN_ROW_PADDING * 2);
+	return (rows > 0) ? (size_t)rows : 0;
+}
+
 static void wprint_label(WINDOW* win, const char label[], const unsigned char label_padding)
 {
 	unsigned char label_len = (unsigned char)strlen(label);
@@ -278,14 +421,17 @@ static void window_clock_update(WINDOW* win, const struct ngc_clock clock)
 	getyx(win, y, x);
 
 	wprint_label(win, "Status", 6);
-	wprintw(win, clock.enabled ? "Running" : "Paused");
+	if (clock.enabled && clock.run_to)
+		wprintw(win, "Run to %hu", clock.run_to_pc);
+	else
+		wprintw(win, clock.enabled ? "Running" : "Paused");
 	wclrtoeol(win);
 
 	y++;
 	wmove(win, y, x);
 
 	wprint_label(win, "Freq", 6);
-	wprintw(win, "%hd Hz", clock.hz);
+	wprintw(win, "%hu Hz", clock.hz);
 	wclrtoeol(win);
 
 	window_update_finish(win, "Clock");
@@ -321,17 +467,111 @@ static void window_internal_update(WINDOW* win, const struct ngc_tick tick)
 	window_update_finish(win, "Internal");
 }
 
-static void window_ram_update(WINDOW* win, const struct ngc_tick tick, const struct dynarr ram)
+static void window_perf_update(WINDOW* win, const struct perf_stats perf, const struct ngc_clock clock)
 {
 	window_update_start(win);
 
 	int y, x;
 	getyx(win, y, x);
 
-	// Print portion of RAM around address given in A register
+	wprint_label(win, "Rate", 5);
+	wprintw(win, "%lld/%hu", perf.ticks_per_sec, clock.hz);
+	wclrtoeol(win);
+
+	y++;
+	wmove(win, y, x);
+
+	wprint_label(win, "Jit50", 5);
+	wprintw(win, "%lld us", perf.jitter_p50_us);
+	wclrtoeol(win);
+
+	y++;
+	wmove(win, y, x);
+
+	wprint_label(win, "Jit99", 5);
+	wprintw(win, "%lld us", perf.jitter_p99_us);
+	wclrtoeol(win);
+
+	y++;
+	wmove(win, y, x);
+
+	wprint_label(win, "Draw", 5);
+	wprintw(win, "%lld us", perf.draw_us);
+	wclrtoeol(win);
+
+	y++;
+	wmove(win, y, x);
+
+	wprint_label(win, "Input", 5);
+	wprintw(win, "%lld us", perf.in_latency_us);
+	wclrtoeol(win);
+
+	window_update_finish(win, "Perf");
+}
+
+/**
+ * Get address at top of memory view, scrolling view to keep its cursor or the given target address visible.
+ */
+static size_t mem_view_scroll(struct mem_view* view, const size_t addr_target, const size_t lines)
+{
+	if (lines == 0)
+		return addr_target;
+
+	// Show page of addresses around target address
+	if (!view->pinned) {
+		view->top = MEM_ADDR_INIT(addr_target, lines);
+		return view->top;
+	}
+
+	// Scroll only as far as required to show cursor
+	if (view->cursor < view->top)
+		view->top = view->cursor;
+	else if (view->cursor >= view->top + lines)
+		view->top = view->cursor - lines + 1;
+
+	return view->top;
+}
+
+/**
+ * Move cursor of memory view, pinning the view if following the given target address.
+ */
+static void mem_view_move(struct mem_view* view, const size_t addr_target, const long long delta)
+{
+	if (!view->pinned) {
+		view->pinned = true;
+		view->cursor = addr_target;
+	}
+
+	long long cursor = (long long)view->cursor + delta;
+	if (cursor < 0)
+		cursor = 0;
+	else if (cursor > NGC_RXM_LEN)
+		cursor = NGC_RXM_LEN;
+
+	view->cursor = (size_t)cursor;
+}
+
+/**
+ * Pin memory view to address.
+ */
+static void mem_view_pin(struct mem_view* view, const size_t addr)
+{
+	view->pinned = true;
+	view->cursor = (addr > NGC_RXM_LEN) ? NGC_RXM_LEN : addr;
+}
+
+static void window_ram_update(WINDOW* win, const struct ngc_tick tick, const struct ngc_mem* mem, struct mem_view* view, const bool focus)
+{
+	window_update_start(win);
+
+	int y, x;
+	getyx(win, y, x);
+
+	// Print only the portion of RAM visible within window
+	size_t lines = window_lines(win);
 	size_t addr_target = (size_t)(ngc_uword_t)tick.in.a;
-	size_t addr_start = MEM_ADDR_INIT(addr_target, WIN_RAM_LINES);
-	for (size_t addr = addr_start; addr <= addr_start + WIN_RAM_LINES; addr++, y++) {
+	size_t addr_start = mem_view_scroll(view, addr_target, lines);
+	for (size_t addr = addr_start; addr < addr_start + lines; addr++, y++) {
 		// Clear line if address exceeds RAM size
 		if (addr > NGC_RXM_LEN) {
 			wmove(win, y, x);
@@ -343,6 +583,9 @@ static void window_ram_update(WINDOW* win, const struct ngc_tick tick, const str
 		char label[NGC_UWORD_DEC_STR_LEN + 1] = { 0 };
 		sprintf(label, "%zu", addr);
 
+		if (view->pinned && addr == view->cursor)
+			wattron(win, A_UNDERLINE);
+
 		// Print diff of value at address between ticks
 		if (addr == addr_target) {
 			wattron(win, A_REVERSE);
@@ -350,25 +593,28 @@ static void window_ram_update(WINDOW* win, const struct ngc_tick tick, const str
 			wattroff(win, A_REVERSE);
 		// Print value at address
 		} else {
-			mvwprint_result_val(win, y, x, label, NGC_UWORD_DEC_STR_LEN, ngc_rxm_get(ram, addr));
+			mvwprint_result_val(win, y, x, label, NGC_UWORD_DEC_STR_LEN, ngc_ram_get(mem, (ngc_uword_t)addr));
 			wclrtoeol(win); // Clear any potential previous diffs
 		}
+
+		wattroff(win, A_UNDERLINE);
 	}
 
-	window_update_finish(win, "RAM [A: *A]");
+	window_update_finish_attr(win, view->pinned ? "RAM [Pinned]" : "RAM [A: *A]", focus ? A_BOLD : A_DIM);
 }
 
-static void window_rom_update(WINDOW* win, const struct ngc_tick tick, const struct dynarr rom)
+static void window_rom_update(WINDOW* win, const struct ngc_tick tick, const struct ngc_mem* mem, struct mem_view* view, const bool focus)
 {
 	window_update_start(win);
 
 	int y, x;
 	getyx(win, y, x);
 
-	// Print portion of ROM around address given in PC register
+	// Print only the portion of ROM visible within window
+	size_t lines = window_lines(win);
 	size_t addr_target = (size_t)(ngc_uword_t)tick.in.pc;
-	size_t addr_start = MEM_ADDR_INIT(addr_target, WIN_ROM_LINES);
-	for (size_t addr = addr_start; addr <= addr_start + WIN_ROM_LINES; addr++, y++) {
+	size_t addr_start = mem_view_scroll(view, addr_target, lines);
+	for (size_t addr = addr_start; addr < addr_start + lines; addr++, y++) {
 		// Clear line if address exceeds ROM size
 		if (addr > NGC_RXM_LEN) {
 			wmove(win, y, x);
@@ -380,17 +626,19 @@ static void window_rom_update(WINDOW* win, const struct ngc_tick tick, const str
 		char label[NGC_UWORD_DEC_STR_LEN + 1] = { 0 };
 		sprintf(label, "%zu", addr);
 
+		if (view->pinned && addr == view->cursor)
+			wattron(win, A_UNDERLINE);
+
 		if (addr == addr_target)
 			wattron(win, A_REVERSE);
 
 		// Print value at address
-		mvwprint_result_val(win, y, x, label, NGC_UWORD_DEC_STR_LEN, ngc_rxm_get(rom, addr));
+		mvwprint_result_val(win, y, x, label, NGC_UWORD_DEC_STR_LEN, ngc_rom_get(mem, (ngc_uword_t)addr));
 
-		if (addr == addr_target)
-			wattroff(win, A_REVERSE);
+		wattroff(win, A_REVERSE | A_UNDERLINE);
 	}
 
-	window_update_finish(win, "ROM [PC: In]");
+	window_update_finish_attr(win, view->pinned ? "ROM [Pinned]" : "ROM [PC: In]", focus ? A_BOLD : A_DIM);
 }
 
 static bool windows_init(struct display_wins* wins, const struct term* term)
@@ -398,9 +646,11 @@ static bool windows_init(struct display_wins* wins, const struct term* term)
 	if (!wins || !term)
 		return false;
 
-	int y_offset = WINS_OFFSET_Y(term->rows);
+	int y_offset = 0;
 	int x_offset = WINS_OFFSET_X(term->cols);
 
+	*wins = (struct display_wins){ 0 };
+
 	wins->clock = derwin(term->win, WIN_CLOCK_ROWS, WIN_GROUP_1_COLS, WIN_CLOCK_Y + y_offset, WIN_GROUP_1_X + x_offset);
 	if (!wins->clock)
 		goto error;
@@ -413,11 +663,15 @@ static bool windows_init(struct display_wins* wins, const struct term* term)
 	if (!wins->internal)
 		goto error;
 
-	wins->ram = derwin(term->win, WIN_RAM_ROWS, WIN_GROUP_2_COLS, WIN_RAM_Y + y_offset, WIN_GROUP_2_X + x_offset);
+	wins->perf = derwin(term->win, WIN_PERF_ROWS, WIN_GROUP_1_COLS, WIN_PERF_Y + y_offset, WIN_GROUP_1_X + x_offset);
+	if (!wins->perf)
+		goto error;
+
+	wins->ram = derwin(term->win, WIN_MEM_ROWS(term->rows), WIN_GROUP_2_COLS, WIN_RAM_Y + y_offset, WIN_GROUP_2_X + x_offset);
 	if (!wins->ram)
 		goto error;
 
-	wins->rom = derwin(term->win, WIN_ROM_ROWS, WIN_GROUP_3_COLS, WIN_ROM_Y + y_offset, WIN_GROUP_3_X + x_offset);
+	wins->rom = derwin(term->win, WIN_MEM_ROWS(term->rows), WIN_GROUP_3_COLS, WIN_ROM_Y + y_offset, WIN_GROUP_3_X + x_offset);
 	if (!wins->rom)
 		goto error;
 
@@ -427,18 +681,21 @@ static bool windows_init(struct display_wins* wins, const struct term* term)
 	if (wins->clock) delwin(wins->clock);
 	if (wins->registers) delwin(wins->registers);
 	if (wins->internal) delwin(wins->internal);
+	if (wins->perf) delwin(wins->perf);
 	if (wins->ram) delwin(wins->ram);
 	if (wins->rom) delwin(wins->rom);
+	*wins = (struct display_wins){ 0 };
 	return false;
 }
 
-static void windows_update(const struct display_wins wins, const struct ngc_clock clock, const struct ngc_tick tick, const struct ngc_mem mem)
+static void windows_update(const struct display_wins wins, const struct ngc_clock clock, const struct ngc_tick tick, const struct ngc_mem* mem, const struct perf_stats perf, struct mem_views* views)
 {
 	window_clock_update(wins.clock, clock);
 	window_registers_update(wins.registers, tick);
 	window_internal_update(wins.internal, tick);
-	window_ram_update(wins.ram, tick, mem.ram);
-	window_rom_update(wins.rom, tick, mem.rom);
+	window_perf_update(wins.perf, perf, clock);
+	window_ram_update(wins.ram, tick, mem, &views->ram, views->focus == VIEW_RAM_E);
+	window_rom_update(wins.rom, tick, mem, &views->rom, views->focus == VIEW_ROM_E);
 }
 
 static void windows_free(struct display_wins* wins)
@@ -449,11 +706,12 @@ static void windows_free(struct display_wins* wins)
 	delwin(wins->clock);
 	delwin(wins->registers);
 	delwin(wins->internal);
+	delwin(wins->perf);
 	delwin(wins->ram);
 	delwin(wins->rom);
 }
 
-static bool windows_resized(struct display_wins* wins, const struct term* term, const int prev_term_rows, const int prev_term_cols)
+static bool windows_resized(struct display_wins* wins, const struct term* term)
 {
 	if (!wins || !term)
 		return false;
@@ -462,32 +720,17 @@ static bool windows_resized(struct display_wins* wins, const struct term* term,
 	if (term->rows < WINS_TOTAL_ROWS || term->cols < WINS_TOTAL_COLS)
 		return true;
 
-	// Terminal fit windows before resize - move windows
-	if (prev_term_rows >= WINS_TOTAL_ROWS && prev_term_cols >= WINS_TOTAL_COLS) {
-		int y_offset = WINS_OFFSET_Y(term->rows);
-		int x_offset = WINS_OFFSET_X(term->cols);
-
-		mvwin(wins->clock, WIN_CLOCK_Y + y_offset, WIN_GROUP_1_X + x_offset);
-		mvwin(wins->registers, WIN_REG_Y + y_offset, WIN_GROUP_1_X + x_offset);
-		mvwin(wins->internal, WIN_INTR_Y + y_offset, WIN_GROUP_1_X + x_offset);
-		mvwin(wins->ram, WIN_RAM_Y + y_offset, WIN_GROUP_2_X + x_offset);
-		mvwin(wins->rom, WIN_ROM_Y + y_offset, WIN_GROUP_3_X + x_offset);
-
-		return true;
-	// Terminal did not fit windows before resize - re-init windows
-	// Terminal shrinking also shrinks windows which cannot be resized
-	} else {
-		windows_free(wins);
-		return windows_init(wins, term);
-	}
+	// Re-init windows - RAM and ROM windows are resized to fit terminal height
+	windows_free(wins);
+	return windows_init(wins, term);
 }
 
 /**
- * Set values of RAM/ROM in NandGame computer memory to values of read file.
+ * Set ROM in NandGame computer memory to values of read file.
  */
-static bool ngc_rxm_set_fp(struct dynarr* rxm, const ngc_uword_t addr, FILE* fp)
+static bool ngc_rom_set_fp(struct ngc_mem* mem, FILE* fp)
 {
-	if (!rxm || !fp)
+	if (!mem || !fp)
 		return false;
 
 	// Read file bytes into buffer array
@@ -504,7 +747,7 @@ static bool ngc_rxm_set_fp(struct dynarr* rxm, const ngc_uword_t addr, FILE* fp)
 		return false;
 
 	// Copy file buffer into NGC data
-	if (!ngc_rxm_set(rxm, addr, (ngc_word_t*)buffer, (size_t)buffer_words.quot))
+	if (!ngc_rom_set(mem, (ngc_word_t*)buffer, (size_t)buffer_words.quot))
 		return false;
 
 	return true;
@@ -532,10 +775,30 @@ static unsigned short parse_clock_hz_opt(char* optarg)
 	return result;
 }
 
+static long parse_addr(const char* str)
+{
+	if (!str || !str[0])
+		return -1;
+
+	int base = 10;
+	if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+		base = 16;
+		str += 2;
+	}
+
+	char* str_end = NULL;
+	long result = strtol(str, &str_end, base);
+
+	if (str_end == str || *str_end || result < 0 || result > NGC_UWORD_MAX)
+		return -1;
+
+	return result;
+}
+
 /**
  * Calculate processor tick result.
  */
-static void tick_calc(const struct ngc_mem mem, struct ngc_tick* tick, struct ngc_clock* clock)
+static void tick_calc(const struct ngc_mem* mem, struct ngc_tick* tick, struct ngc_clock* clock)
 {
 	if (!tick)
 		return;
@@ -543,10 +806,41 @@ static void tick_calc(const struct ngc_mem mem, struct ngc_tick* tick, struct ng
 	ngc_tick_calc(tick, mem);
 
 	// Pause clock if next processor tick will end emulation
-	if (clock && clock->disable_on_complete && tick->out.pc >= mem.rom.len)
+	if (clock && clock->disable_on_complete && tick->out.pc >= ngc_rom_len(mem))
 		clock->enabled = false;
 }
 
+/**
+ * Tick processor at maximum speed until PC reaches address to run to, clock is paused, end of ROM is reached, or given time is reached.
+ *
+ * @returns Number of processor ticks. -1 if error.
+ */
+static long long tick_run_to(struct ngc_mem* mem, struct ngc_tick* tick, struct ngc_clock* clock, const long long until_epoch_us)
+{
+	long long result = 0;
+
+	do {
+		for (size_t ind = 0; ind < RUN_TO_TICKS_PER_EPOCH; ind++) {
+			if (!ngc_tick_set(mem, *tick))
+				return -1;
+
+			tick_calc(mem, tick, clock);
+			result++;
+
+			// Address reached - pause clock
+			if (mem->pc == clock->run_to_pc) {
+				clock->enabled = false;
+				clock->run_to = false;
+			}
+
+			if (!clock->enabled || mem->pc >= ngc_rom_len(mem))
+				return result;
+		}
+	} while (get_epoch_us() < until_epoch_us);
+
+	return result;
+}
+
 // Data to manage in signal handlers
 bool term_set = false, windows_set = false;
 struct term term = { 0 };
@@ -631,9 +925,6 @@ int main(int argc, char* argv[])
 		rom_path = argv[optind];
 	}
 
-	// Pre-allocate space for NGC memory
-	ngc_mem_alloc(&mem);
-
 	// Open ROM file
 	bool rom_stdin = !rom_path || strncmp(rom_path, PATH_STDIN, strlen(PATH_STDIN) + 1) == 0;
 	FILE* rom_fp = rom_stdin ? stdin : fopen(rom_path, "rb");
@@ -643,7 +934,7 @@ int main(int argc, char* argv[])
 	}
 
 	// Load ROM file into NGC memory
-	bool rom_loaded = ngc_rxm_set_fp(&mem.rom, 0, rom_fp);
+	bool rom_loaded = ngc_rom_set_fp(&mem, rom_fp);
 	fclose(rom_fp);
 	if (!rom_loaded) {
 		snprintf(exit_err, ERR_LEN_MAX, "Failed to load ROM file into NGC memory");
@@ -671,18 +962,33 @@ int main(int argc, char* argv[])
 
 	long long last_term_in_epoch_us = 0, last_tick_epoch_us = 0, last_term_out_epoch_us = 0;
 	struct ngc_tick tick = { 0 };
+	struct perf_stats perf = { 0 };
+	struct mem_views views = { .focus = VIEW_RAM_E };
 
 	// Calculate first processor tick result
-	tick_calc(mem, &tick, &clock);
+	tick_calc(&mem, &tick, &clock);
 	last_tick_epoch_us = get_epoch_us();
+	perf.period_epoch_us = last_tick_epoch_us;
 
 	// Update emulation until end of ROM reached
-	while (mem.pc < mem.rom.len) {
+	while (mem.pc < ngc_rom_len(&mem)) {
 		bool reset = false, step = false;
 
 		// Read keyboard input if due
 		if (get_epoch_us() - last_term_in_epoch_us >= US_PER_TERM_IN) {
-			switch (term_get_in(&term)) {
+			int in = term_get_in(&term);
+			if (in != ERR && perf.in_epoch_us == 0)
+				perf.in_epoch_us = get_epoch_us();
+
+			// Focused memory view, and the address it follows when not pinned
+			bool view_ram = views.focus == VIEW_RAM_E;
+			struct mem_view* view = view_ram ? &views.ram : &views.rom;
+			size_t view_target = view_ram ? (size_t)(ngc_uword_t)tick.in.a : (size_t)tick.in.pc;
+			long long view_lines = (long long)window_lines(view_ram ? windows.ram : windows.rom);
+
+			char prompt_in[PROMPT_LEN_MAX + 1] = { 0 };
+
+			switch (in) {
 				case 'q':
 				case 'Q':
 				case 27: // Esc
@@ -700,6 +1006,60 @@ int main(int argc, char* argv[])
 				case 'S':
 					step = !clock.enabled;
 					break;
+				case 'g':
+				case 'G':
+					;
+					long run_to_pc = term_prompt(&term, "Run to address: ", prompt_in, PROMPT_LEN_MAX) ? parse_addr(prompt_in) : -1;
+					if (run_to_pc >= 0) {
+						clock.enabled = true;
+						clock.run_to = true;
+						clock.run_to_pc = (ngc_uword_t)run_to_pc;
+					}
+
+					// Redraw display windows cleared by prompt
+					last_term_out_epoch_us = 0;
+					break;
+				case '\t':
+					views.focus = view_ram ? VIEW_ROM_E : VIEW_RAM_E;
+					last_term_out_epoch_us = 0;
+					break;
+				case KEY_UP:
+					mem_view_move(view, view_target, -1);
+					last_term_out_epoch_us = 0;
+					break;
+				case KEY_DOWN:
+					mem_view_move(view, view_target, 1);
+					last_term_out_epoch_us = 0;
+					break;
+				case KEY_PPAGE:
+					mem_view_move(view, view_target, -view_lines);
+					last_term_out_epoch_us = 0;
+					break;
+				case KEY_NPAGE:
+					mem_view_move(view, view_target, view_lines);
+					last_term_out_epoch_us = 0;
+					break;
+				case KEY_HOME:
+					view->pinned = false;
+					last_term_out_epoch_us = 0;
+					break;
+				case 'j':
+				case 'J':
+					;
+					long view_addr = term_prompt(&term, "View address: ", prompt_in, PROMPT_LEN_MAX) ? parse_addr(prompt_in) : -1;
+					if (view_addr >= 0)
+						mem_view_pin(view, (size_t)view_addr);
+
+					// Redraw display windows cleared by prompt
+					last_term_out_epoch_us = 0;
+					break;
+				case '*':
+					;
+					// Follow value at cursor as a pointer
+					ngc_uword_t view_ptr = (ngc_uword_t)(view_ram ? ngc_ram_get : ngc_rom_get)(&mem, view->pinned ? view->cursor : view_target);
+					mem_view_pin(view, (size_t)view_ptr);
+					last_term_out_epoch_us = 0;
+					break;
 				case '[':
 					if (clock.hz > CLOCK_HZ_MIN)
 						clock.hz /= CLOCK_HZ_MULTI;
@@ -715,17 +1075,39 @@ int main(int argc, char* argv[])
 
 		long long us_per_tick = US_PER_SEC / clock.hz;
 
+		// Running to address is cancelled once clock is paused
+		if (!clock.enabled)
+			clock.run_to = false;
+
+		// Ticks not driven by the running clock cannot be timed
+		if (!clock.enabled || clock.run_to || step || reset)
+			perf_tick_break(&perf);
+
 		// Reset processor
 		if (reset) {
 			ngc_mem_reset(&mem);
 
 			// Calculate first processor tick result
-			tick_calc(mem, &tick, &clock);
+			tick_calc(&mem, &tick, &clock);
 			last_tick_epoch_us = get_epoch_us();
 		}
 
+		// Tick processor at maximum speed until running to address is complete or terminal input/output is due
+		if (clock.run_to) {
+			long long until_epoch_us = last_term_in_epoch_us + US_PER_TERM_IN;
+			if (last_term_out_epoch_us + US_PER_TERM_OUT < until_epoch_us)
+				until_epoch_us = last_term_out_epoch_us + US_PER_TERM_OUT;
+
+			long long run_to_ticks = tick_run_to(&mem, &tick, &clock, until_epoch_us);
+			if (run_to_ticks < 0) {
+				snprintf(exit_err, ERR_LEN_MAX, "Failed to set memory to processor tick result");
+				goto exit;
+			}
+
+			last_tick_epoch_us = get_epoch_us();
+			perf.period_ticks += run_to_ticks;
 		// Tick processor if due
-		if (step || (clock.enabled && get_epoch_us() - last_tick_epoch_us >= us_per_tick)) {
+		} else if (step || (clock.enabled && get_epoch_us() - last_tick_epoch_us >= us_per_tick)) {
 			// Set NandGame computer memory to processor tick result
 			if (!ngc_tick_set(&mem, tick)) {
 				snprintf(exit_err, ERR_LEN_MAX, "Failed to set memory to processor tick result");
@@ -733,16 +1115,16 @@ int main(int argc, char* argv[])
 			}
 
 			// Calculate next processor tick result
-			tick_calc(mem, &tick, &clock);
+			tick_calc(&mem, &tick, &clock);
 			last_tick_epoch_us = get_epoch_us();
+			perf_tick(&perf, last_tick_epoch_us, us_per_tick);
 		}
 
 		// Draw display windows if due
 		if (get_epoch_us() - last_term_out_epoch_us >= US_PER_TERM_OUT) {
 			// Update display windows on terminal resize
-			int prev_term_rows, prev_term_cols;
-			if (term_resized(&term, &prev_term_rows, &prev_term_cols)) {
-				if (!windows_resized(&windows, &term, prev_term_rows, prev_term_cols)) {
+			if (term_resized(&term, NULL, NULL)) {
+				if (!windows_resized(&windows, &term)) {
 					snprintf(exit_err, ERR_LEN_MAX, "Failed to resize display windows");
 					goto exit;
 				}
@@ -750,8 +1132,18 @@ int main(int argc, char* argv[])
 				term_clear(&term);
 			}
 
-			windows_update(windows, clock, tick, mem);
+			long long draw_epoch_us = get_epoch_us();
+			perf_calc(&perf, draw_epoch_us);
+
+			windows_update(windows, clock, tick, &mem, perf, &views);
 			last_term_out_epoch_us = get_epoch_us();
+
+			// Measure time taken to draw, and time taken for any keyboard input to be drawn
+			perf.draw_us = last_term_out_epoch_us - draw_epoch_us;
+			if (perf.in_epoch_us > 0) {
+				perf.in_latency_us = last_term_out_epoch_us - perf.in_epoch_us;
+				perf.in_epoch_us = 0;
+			}
 		}
 
 		// Get times events are next due
@@ -770,7 +1162,7 @@ int main(int argc, char* argv[])
 
 		// Sleep until next event is due
 		long long sleep_time_us = next_event_epoch_us - get_epoch_us();
-		if (sleep_time_us > 0)
+		if (sleep_time_us > 0 && !clock.run_to)
 			sleep_us(sleep_time_us);
 	}
 
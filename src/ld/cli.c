@@ -0,0 +1,264 @@
+#define _XOPEN_SOURCE 600
+
+#include "../asm/str.h"
+#include "../dynarr.h"
+#include "../ngc.h"
+#include "../object.h"
+#include "../print.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PATH_STDIN "-"
+#define PATH_STDOUT "-"
+
+enum exit_val {
+	SUCCESS_E = 0,
+	FAILURE_E = 1 << 0, // Unknown/general failure
+	INVALID_ARGS_E = 1 << 1, // Invalid CLI arguments
+	INVALID_FILE_E = 1 << 2, // Invalid object file
+	INVALID_LINK_E = 1 << 3 // Symbols of object files cannot be linked
+};
+
+/**
+ * Object file being linked.
+ */
+struct module {
+	const char* path;
+	struct object obj;
+	size_t base; // Address the object file is linked at
+};
+
+DYNARR_DEFINE(struct module, module)
+
+/**
+ * Symbol exported by object file being linked.
+ */
+struct export {
+	const struct object_symbol* symbol;
+	size_t module_ind; // Index of object file exporting symbol
+	size_t val; // Value of symbol, with labels offset by the address the object file is linked at
+};
+
+DYNARR_DEFINE(struct export, export)
+
+/**
+ * Free values within object file being linked.
+ */
+static void module_empty(struct module* module)
+{
+	if (!module)
+		return;
+
+	object_empty(&module->obj);
+}
+
+static void module_empty_v(void* p) { module_empty(p); }
+
+/**
+ * Compare keys of exported symbols, ignoring case the same as the assembler.
+ */
+static int export_key_comp(const void* p1, const void* p2)
+{
+	const struct export* e1 = p1;
+	const struct export* e2 = p2;
+	return str_comp(e1->symbol->key, e2->symbol->key, OBJECT_KEY_LEN_MAX + 1, tolower);
+}
+
+/**
+ * Compare exported symbols by key, then by order of object files exporting them.
+ */
+static int export_comp(const void* p1, const void* p2)
+{
+	int key_comp = export_key_comp(p1, p2);
+	if (key_comp != 0)
+		return key_comp;
+
+	const struct export* e1 = p1;
+	const struct export* e2 = p2;
+	return (e1->module_ind > e2->module_ind) - (e1->module_ind < e2->module_ind);
+}
+
+int main(int argc, char* argv[])
+{
+	enum exit_val exit_val = FAILURE_E;
+	char* out_path = NULL;
+
+	int opt;
+	extern char* optarg;
+	extern int optind, optopt;
+
+	struct dynarr modules = { 0 }; // Dynamic array of module, in order given
+	struct dynarr exports = { 0 }; // Dynamic array of export, in order of key once all object files are read
+	struct dynarr rom = { 0 }; // Dynamic array of ngc_word_t, linked instructions
+
+	// Set vars from opts
+	while ((opt = getopt(argc, argv, ":o:vV")) != -1) {
+		switch (opt) {
+			case 'o':
+				out_path = optarg;
+				break;
+			case 'v':
+			case 'V':
+				printf("ngc-ld v0.1.0%s", EOL);
+				return SUCCESS_E;
+			case ':':
+				print_err("Option -%c requires an argument", optopt);
+				return INVALID_ARGS_E;
+			case '?':
+				print_err("Unknown option: -%c", optopt);
+				return INVALID_ARGS_E;
+		}
+	}
+
+	if (optind >= argc) {
+		print_err("No object files given");
+		return INVALID_ARGS_E;
+	}
+
+	// Read object files, each linked after the previous
+	size_t insts_len = 0;
+	bool in_stdin_read = false;
+	for (; optind < argc; optind++) {
+		bool in_stdin = strncmp(argv[optind], PATH_STDIN, strlen(PATH_STDIN) + 1) == 0;
+		struct module module = { .path = argv[optind], .base = insts_len };
+
+		if (in_stdin && in_stdin_read) {
+			print_err("Multiple object files given as stdin");
+			exit_val = INVALID_ARGS_E;
+			goto exit;
+		}
+
+		in_stdin_read = in_stdin_read || in_stdin;
+
+		FILE* in_fp = in_stdin ? stdin : fopen(module.path, "rb");
+		if (!in_fp) {
+			print_err("%s: Failed to open file", module.path);
+			exit_val = INVALID_FILE_E;
+			goto exit;
+		}
+
+		bool in_read = object_read(&module.obj, in_fp);
+		if (!in_stdin)
+			fclose(in_fp);
+
+		if (!in_read) {
+			print_err("%s: Failed to read object file", module.path);
+			exit_val = INVALID_FILE_E;
+			goto exit;
+		}
+
+		if (!dynarr_module_push(&modules, module)) {
+			object_empty(&module.obj);
+			print_err("Failed to push object file");
+			goto exit;
+		}
+
+		insts_len += module.obj.insts.len;
+		if (insts_len > NGC_UWORD_MAX) {
+			print_err("%s: Linked files contain too many instructions (max %zu)", module.path, NGC_UWORD_MAX);
+			exit_val = INVALID_FILE_E;
+			goto exit;
+		}
+
+		// Export symbols of object file
+		for (size_t symbols_ind = 0; symbols_ind < module.obj.symbols.len; symbols_ind++) {
+			struct object_symbol* symbol = dynarr_object_symbol_get(&module.obj.symbols, symbols_ind);
+			struct export export = { .symbol = symbol, .module_ind = modules.len - 1, .val = symbol->val };
+			if (symbol->type == OBJECT_SYMBOL_LABEL_E)
+				export.val += module.base;
+
+			if (!dynarr_export_push(&exports, export)) {
+				print_err("Failed to push exported symbol");
+				goto exit;
+			}
+		}
+	}
+
+	// Sort exported symbols to look up relocations by key
+	if (exports.len > 1)
+		qsort(exports.vals, exports.len, sizeof(struct export), export_comp);
+
+	// Validate each key is only exported once, other than constants of the same value defined within a shared included file
+	for (size_t exports_ind = 1; exports_ind < exports.len; exports_ind++) {
+		struct export* first = dynarr_export_get(&exports, exports_ind - 1);
+		struct export* export = dynarr_export_get(&exports, exports_ind);
+		if (export_key_comp(first, export) != 0)
+			continue;
+
+		if (first->symbol->type == OBJECT_SYMBOL_CONST_E && export->symbol->type == OBJECT_SYMBOL_CONST_E && first->val == export->val)
+			continue;
+
+		struct module* module_first = dynarr_module_get(&modules, first->module_ind);
+		struct module* module = dynarr_module_get(&modules, export->module_ind);
+		print_err("%s: Conflicting key exported, first exported by '%s': '%s'", module->path, module_first->path, export->symbol->key);
+		exit_val = INVALID_LINK_E;
+		goto exit;
+	}
+
+	// Failure to pre-allocate space is non-critical - not checking return result
+	dynarr_alloc(&rom, (insts_len > 0) ? insts_len : 1, sizeof(ngc_word_t));
+
+	// Link object files, patching relocations of each
+	for (size_t modules_ind = 0; modules_ind < modules.len; modules_ind++) {
+		struct module* module = dynarr_module_get(&modules, modules_ind);
+		if (module->obj.insts.len == 0)
+			continue;
+
+		ngc_word_t* insts = dynarr_set(&rom, module->base, module->obj.insts.vals, module->obj.insts.len, sizeof(ngc_word_t));
+		if (!insts) {
+			print_err("Failed to push linked instructions");
+			goto exit;
+		}
+
+		for (size_t relocs_ind = 0; relocs_ind < module->obj.relocs.len; relocs_ind++) {
+			struct object_reloc* reloc = dynarr_object_reloc_get(&module->obj.relocs, relocs_ind);
+
+			// Address within object file
+			if (reloc->type == OBJECT_RELOC_BASE_E) {
+				insts[reloc->offset] = (ngc_word_t)(ngc_uword_t)((ngc_uword_t)insts[reloc->offset] + module->base);
+				continue;
+			}
+
+			// Data reference defined by another object file
+			struct object_symbol symbol_key = { 0 };
+			memcpy(symbol_key.key, reloc->key, sizeof(symbol_key.key));
+			struct export export_key = { .symbol = &symbol_key };
+			struct export* export = (exports.len > 0) ? bsearch(&export_key, exports.vals, exports.len, sizeof(struct export), export_key_comp) : NULL;
+			if (!export) {
+				print_err("%s: Data reference not defined: '%s'", module->path, reloc->key);
+				exit_val = INVALID_LINK_E;
+				goto exit;
+			}
+
+			insts[reloc->offset] = (ngc_word_t)export->val;
+		}
+	}
+
+	bool out_stdout = !out_path || strncmp(out_path, PATH_STDOUT, strlen(PATH_STDOUT) + 1) == 0;
+	char* out_name = out_stdout ? PATH_STDOUT : out_path;
+
+	// Open output file
+	FILE* out_fp = out_stdout ? stdout : fopen(out_path, "wb");
+	if (!out_fp) {
+		print_err("%s: Failed to open file", out_name);
+		exit_val = INVALID_FILE_E;
+		goto exit;
+	}
+
+	// Output linked instructions
+	fwrite(rom.vals, sizeof(ngc_word_t), rom.len, out_fp);
+	fclose(out_fp);
+
+	exit_val = SUCCESS_E;
+
+	exit:
+	dynarr_delegate_empty(&modules, module_empty_v);
+	dynarr_empty(&exports);
+	dynarr_empty(&rom);
+	return exit_val;
+}
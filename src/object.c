@@ -0,0 +1,167 @@
+#include "object.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define OBJECT_MAGIC "NGCO"
+#define OBJECT_MAGIC_LEN 4
+#define OBJECT_VERSION 1
+
+/**
+ * Header of object file, followed by instructions, then symbols, then relocations.
+ */
+struct object_header {
+	char magic[OBJECT_MAGIC_LEN];
+	uint32_t version;
+	uint32_t insts_len;
+	uint32_t symbols_len;
+	uint32_t relocs_len;
+};
+
+/**
+ * Entry of symbol or relocation within object file, followed by its key.
+ */
+struct object_entry {
+	uint8_t type;
+	uint8_t key_len;
+	ngc_uword_t val; // Value of symbol, or offset of relocation
+};
+
+/**
+ * Write entry of symbol or relocation, followed by its key.
+ *
+ * @param fp File pointer to write to.
+ * @param type Type of symbol or relocation.
+ * @param val Value of symbol, or offset of relocation.
+ * @param key Null-terminated key.
+ * @returns Whether entry was written successfully.
+ */
+static bool entry_write(FILE* fp, const int type, const ngc_uword_t val, const char* key)
+{
+	size_t key_len = strlen(key);
+	if (key_len > OBJECT_KEY_LEN_MAX)
+		return false;
+
+	struct object_entry entry = { .type = (uint8_t)type, .key_len = (uint8_t)key_len, .val = val };
+	return fwrite(&entry, sizeof(entry), 1, fp) == 1 && fwrite(key, sizeof(char), key_len, fp) == key_len;
+}
+
+/**
+ * Read entry of symbol or relocation, followed by its key.
+ *
+ * @param entry Struct to store entry.
+ * @param key Buffer to store null-terminated key, fitting OBJECT_KEY_LEN_MAX characters.
+ * @param fp File pointer to read from.
+ * @returns Whether a valid entry was read successfully.
+ */
+static bool entry_read(struct object_entry* entry, char* key, FILE* fp)
+{
+	if (fread(entry, sizeof(*entry), 1, fp) != 1 || entry->key_len > OBJECT_KEY_LEN_MAX)
+		return false;
+
+	if (fread(key, sizeof(char), entry->key_len, fp) != entry->key_len)
+		return false;
+
+	key[entry->key_len] = '\0';
+	return true;
+}
+
+bool object_write(FILE* fp, const struct object obj)
+{
+	if (!fp || obj.insts.len > UINT32_MAX || obj.symbols.len > UINT32_MAX || obj.relocs.len > UINT32_MAX)
+		return false;
+
+	struct object_header header = { .version = OBJECT_VERSION, .insts_len = (uint32_t)obj.insts.len, .symbols_len = (uint32_t)obj.symbols.len, .relocs_len = (uint32_t)obj.relocs.len };
+	memcpy(header.magic, OBJECT_MAGIC, OBJECT_MAGIC_LEN);
+	if (fwrite(&header, sizeof(header), 1, fp) != 1)
+		return false;
+
+	if (obj.insts.len > 0 && fwrite(obj.insts.vals, sizeof(ngc_word_t), obj.insts.len, fp) != obj.insts.len)
+		return false;
+
+	for (size_t symbols_ind = 0; symbols_ind < obj.symbols.len; symbols_ind++) {
+		struct object_symbol* symbol = dynarr_object_symbol_get(&obj.symbols, symbols_ind);
+		if (!entry_write(fp, symbol->type, symbol->val, symbol->key))
+			return false;
+	}
+
+	for (size_t relocs_ind = 0; relocs_ind < obj.relocs.len; relocs_ind++) {
+		struct object_reloc* reloc = dynarr_object_reloc_get(&obj.relocs, relocs_ind);
+		if (!entry_write(fp, reloc->type, reloc->offset, reloc->key))
+			return false;
+	}
+
+	return fflush(fp) == 0;
+}
+
+bool object_read(struct object* obj, FILE* fp)
+{
+	*obj = (struct object){ 0 };
+
+	struct object_header header;
+	if (!fp || fread(&header, sizeof(header), 1, fp) != 1)
+		return false;
+
+	if (memcmp(header.magic, OBJECT_MAGIC, OBJECT_MAGIC_LEN) != 0 || header.version != OBJECT_VERSION || header.insts_len > NGC_UWORD_MAX)
+		return false;
+
+	// Read instructions
+	if (header.insts_len > 0) {
+		ngc_word_t inst_last = 0;
+		if (!dynarr_set(&obj->insts, header.insts_len - 1, &inst_last, 1, sizeof(inst_last)))
+			goto error;
+
+		if (fread(obj->insts.vals, sizeof(ngc_word_t), obj->insts.len, fp) != obj->insts.len)
+			goto error;
+	}
+
+	// Read symbols
+	for (uint32_t symbols_ind = 0; symbols_ind < header.symbols_len; symbols_ind++) {
+		struct object_entry entry;
+		struct object_symbol symbol;
+		if (!entry_read(&entry, symbol.key, fp) || entry.type > OBJECT_SYMBOL_LABEL_E || entry.key_len == 0)
+			goto error;
+
+		symbol.type = entry.type;
+		symbol.val = entry.val;
+
+		if (symbol.type == OBJECT_SYMBOL_LABEL_E && symbol.val > obj->insts.len)
+			goto error;
+
+		if (!dynarr_object_symbol_push(&obj->symbols, symbol))
+			goto error;
+	}
+
+	// Read relocations
+	for (uint32_t relocs_ind = 0; relocs_ind < header.relocs_len; relocs_ind++) {
+		struct object_entry entry;
+		struct object_reloc reloc;
+		if (!entry_read(&entry, reloc.key, fp) || entry.type > OBJECT_RELOC_SYMBOL_E || entry.val >= obj->insts.len)
+			goto error;
+
+		reloc.type = entry.type;
+		reloc.offset = entry.val;
+
+		if (reloc.type == OBJECT_RELOC_SYMBOL_E && entry.key_len == 0)
+			goto error;
+
+		if (!dynarr_object_reloc_push(&obj->relocs, reloc))
+			goto error;
+	}
+
+	return true;
+
+	error:
+	object_empty(obj);
+	return false;
+}
+
+void object_empty(struct object* obj)
+{
+	if (!obj)
+		return;
+
+	dynarr_empty(&obj->insts);
+	dynarr_empty(&obj->symbols);
+	dynarr_empty(&obj->relocs);
+}
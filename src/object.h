@@ -0,0 +1,83 @@
+#ifndef OBJECT_H
+#define OBJECT_H
+
+#include "dynarr.h"
+#include "ngc.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define OBJECT_KEY_LEN_MAX 0x3F // Max length of key of symbol or relocation, also max length of assembly key
+
+/**
+ * Type of symbol exported by object file.
+ */
+enum object_symbol_type {
+	OBJECT_SYMBOL_CONST_E, // Constant value, from DEFINE statement
+	OBJECT_SYMBOL_LABEL_E // Address within object file, from LABEL statement
+};
+
+/**
+ * Symbol exported by object file.
+ */
+struct object_symbol {
+	enum object_symbol_type type;
+	ngc_uword_t val;
+	char key[OBJECT_KEY_LEN_MAX + 1]; // Null-terminated
+};
+
+DYNARR_DEFINE(struct object_symbol, object_symbol)
+
+/**
+ * Type of relocation of object file.
+ */
+enum object_reloc_type {
+	OBJECT_RELOC_BASE_E, // Address within object file, offset by the address the object file is linked at
+	OBJECT_RELOC_SYMBOL_E // Data reference not defined within object file, resolved to a symbol exported by another object file
+};
+
+/**
+ * Relocation of object file, patching an instruction when linked.
+ */
+struct object_reloc {
+	enum object_reloc_type type;
+	ngc_uword_t offset; // Index of instruction to patch
+	char key[OBJECT_KEY_LEN_MAX + 1]; // Null-terminated key of data reference if type is OBJECT_RELOC_SYMBOL_E
+};
+
+DYNARR_DEFINE(struct object_reloc, object_reloc)
+
+/**
+ * Object file, assembled instructions yet to be linked.
+ */
+struct object {
+	struct dynarr insts; // Dynamic array of ngc_word_t, instructions with relocations unpatched
+	struct dynarr symbols; // Dynamic array of object_symbol
+	struct dynarr relocs; // Dynamic array of object_reloc, in order of offset
+};
+
+/**
+ * Write object file.
+ * Values are written using the system's endianness, the same as NGC instructions.
+ *
+ * @param fp File pointer to write to.
+ * @param obj Object file to write.
+ * @returns Whether object file was written successfully.
+ */
+bool object_write(FILE* fp, const struct object obj);
+
+/**
+ * Read object file.
+ *
+ * @param obj Struct to store object file.
+ * @param fp File pointer to read from.
+ * @returns Whether a valid object file was read successfully.
+ */
+bool object_read(struct object* obj, FILE* fp);
+
+/**
+ * Free values within object file.
+ */
+void object_empty(struct object* obj);
+
+#endif
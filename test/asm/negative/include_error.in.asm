@@ -0,0 +1,2 @@
+D = A
+A = undefined
@@ -0,0 +1,256 @@
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
+D = D + 1
@@ -0,0 +1,16 @@
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
+%INCLUDE insts_256.asm
@@ -0,0 +1,4 @@
+%INCLUDE macros.asm
+
+LABEL lib
+D = A
@@ -0,0 +1,4 @@
+%MACRO load value
+A = value
+D = *A
+%END
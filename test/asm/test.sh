@@ -54,6 +54,24 @@ in_ext='.in' && readonly in_ext
 out_ext='.out' && readonly out_ext
 err_ext='.err' && readonly err_ext
 
+# Create parse cache shared by all tests, so included files are stored by one test and loaded by others
+cache_path="$(mktemp -d)" || _exit_err 3 "Failed to create parse cache directory"
+readonly cache_path
+trap 'rm -rf "$cache_path"' EXIT
+
+# Execute assembly file with parse cache, if it includes other files
+# Executed twice, so included files are both stored to and loaded from the cache
+# $1 assembly file
+# $2 result of execution without parse cache
+# Returns 1 if any result with parse cache differs
+_exe_cached() {
+	grep -qi '%INCLUDE' "$1" || return 0
+
+	for _ in 1 2; do
+		[ "$("$exe_path" -p "$cache_path" "$1" 2>&1)" = "$2" ] || return 1
+	done
+}
+
 # Init test results
 total_count=0
 passed_count=0
@@ -78,7 +96,8 @@ for in_file in $pos_in_files; do
 	# Assert
 	# - Execution should return expected stdout
 	# - Execution should return no stderr - any error should cause assertion to fail
-	if [ "$exe_result" = "$out_expected" ]; then
+	# - Execution with parse cache should return the same result
+	if [ "$exe_result" = "$out_expected" ] && _exe_cached "$in_file" "$exe_result"; then
 		passed_count=$((passed_count + 1))
 	else
 		failed_count=$((failed_count + 1))
@@ -104,7 +123,8 @@ for in_file in $neg_in_files; do
 	# Assert
 	# - Execution should return expected stderr
 	# - Execution should return no stdout - any output should cause assertion to fail
-	if [ "$exe_result" = "$err_expected" ]; then
+	# - Execution with parse cache should return the same result
+	if [ "$exe_result" = "$err_expected" ] && _exe_cached "$in_file" "$exe_result"; then
 		passed_count=$((passed_count + 1))
 	else
 		failed_count=$((failed_count + 1))
@@ -0,0 +1,155 @@
+#include "../../src/emu/emu.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+// Fail test with message if condition is false
+#define TEST_ASSERT(cond) \
+	do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: Assertion failed: %s\n", __func__, __LINE__, #cond); \
+			return false; \
+		} \
+	} while (0)
+
+/**
+ * Unit test of NandGame computer memory.
+ */
+struct test {
+	const char* name;
+	bool (*f)(void);
+};
+
+/**
+ * Get whether all RAM of NandGame computer memory is zero.
+ *
+ * @param mem NandGame computer memory.
+ * @returns Whether all RAM is zero.
+ */
+static bool ram_zero(const struct ngc_mem* mem)
+{
+	for (size_t addr = 0; addr <= NGC_RXM_LEN; addr++) {
+		if (ngc_ram_get(mem, (ngc_uword_t)addr) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Resetting memory after writes scattered across pages clears all RAM, keeping owned pages allocated.
+ */
+static bool test_reset_scattered(void)
+{
+	struct ngc_mem mem = { 0 };
+	const ngc_uword_t addrs[] = { 0x0000, 0x00FF, 0x0100, 0x1234, 0x7FFF, 0x8000, 0xABCD, 0xFFFF };
+	const ngc_word_t run[] = { 1, 2, 3, 4 };
+
+	// Reset twice, so the second reset relies on pages marked dirty after the first
+	for (int pass = 0; pass < 2; pass++) {
+		for (size_t addrs_ind = 0; addrs_ind < sizeof(addrs) / sizeof(addrs[0]); addrs_ind++) {
+			ngc_word_t word = (ngc_word_t)(addrs_ind + 1);
+			TEST_ASSERT(ngc_ram_set(&mem, addrs[addrs_ind], &word, 1));
+		}
+
+		// Run of values crossing page boundary, and write through processor tick
+		TEST_ASSERT(ngc_ram_set(&mem, 0x40FE, run, sizeof(run) / sizeof(run[0])));
+		struct ngc_tick tick = { .in = { .a = 0x6001 }, .out = { .aa = -1 } };
+		TEST_ASSERT(ngc_tick_set(&mem, tick));
+		TEST_ASSERT(ngc_ram_get(&mem, 0x6001) == -1);
+		TEST_ASSERT(ngc_ram_get(&mem, 0x4101) == 4);
+
+		ngc_mem_reset(&mem);
+		TEST_ASSERT(ram_zero(&mem));
+		TEST_ASSERT(mem.ram[0x1234 / NGC_RAM_PAGE_LEN]);
+
+		for (size_t dirty_ind = 0; dirty_ind < sizeof(mem.ram_dirty); dirty_ind++) {
+			TEST_ASSERT(mem.ram_dirty[dirty_ind] == 0);
+		}
+	}
+
+	ngc_mem_empty(&mem);
+	return true;
+}
+
+/**
+ * Memory sharing pages and ROM copies pages on first write, releases shared pages on reset and frees pages once unreferenced.
+ */
+static bool test_share_cow(void)
+{
+	struct ngc_mem src = { 0 };
+	struct ngc_mem dst = { 0 };
+	const ngc_word_t rom[] = { 0x1234, 0x5678 };
+	const ngc_word_t word_src = 7, word_dst = 9, word_other = 11;
+
+	TEST_ASSERT(ngc_rom_set(&src, rom, sizeof(rom) / sizeof(rom[0])));
+	TEST_ASSERT(ngc_ram_set(&src, 0x0010, &word_src, 1));
+	TEST_ASSERT(ngc_ram_set(&src, 0x2010, &word_src, 1));
+	src.a = 3;
+
+	// Share - pages and ROM referenced by both
+	ngc_mem_share(&dst, &src);
+	TEST_ASSERT(dst.a == 3);
+	TEST_ASSERT(dst.rom == src.rom && src.rom->refs == 2);
+	TEST_ASSERT(dst.ram[0] == src.ram[0] && src.ram[0]->refs == 2);
+	TEST_ASSERT(ngc_ram_get(&dst, 0x0010) == word_src);
+	TEST_ASSERT(ngc_rom_get(&dst, 1) == rom[1]);
+
+	// Write - page copied for writer only, other memory unchanged
+	TEST_ASSERT(ngc_ram_set(&dst, 0x0011, &word_dst, 1));
+	TEST_ASSERT(dst.ram[0] != src.ram[0]);
+	TEST_ASSERT(src.ram[0]->refs == 1 && dst.ram[0]->refs == 1);
+	TEST_ASSERT(ngc_ram_get(&dst, 0x0010) == word_src && ngc_ram_get(&dst, 0x0011) == word_dst);
+	TEST_ASSERT(ngc_ram_get(&src, 0x0011) == 0);
+
+	TEST_ASSERT(ngc_ram_set(&src, 0x2011, &word_other, 1));
+	TEST_ASSERT(ngc_ram_get(&dst, 0x2011) == 0);
+	TEST_ASSERT(dst.ram[0x20]->refs == 1);
+
+	// Unwritten page of source written by destination is not shared
+	TEST_ASSERT(ngc_ram_set(&dst, 0x3000, &word_dst, 1));
+	TEST_ASSERT(!src.ram[0x30]);
+
+	// Reset - RAM cleared without writing to memory still shared, ROM kept
+	struct ngc_page* page_shared = src.ram[0x20];
+	TEST_ASSERT(ngc_ram_set(&src, 0x4000, &word_src, 1));
+	ngc_mem_empty(&dst);
+	TEST_ASSERT(src.ram[0x20]->refs == 1 && src.rom->refs == 1);
+	ngc_mem_share(&dst, &src);
+	TEST_ASSERT(src.ram[0x40]->refs == 2);
+	ngc_mem_reset(&dst);
+	TEST_ASSERT(ram_zero(&dst));
+	TEST_ASSERT(!dst.ram[0x40] && src.ram[0x40]->refs == 1);
+	TEST_ASSERT(ngc_ram_get(&src, 0x4000) == word_src && src.ram[0x20] == page_shared);
+	TEST_ASSERT(ngc_rom_get(&dst, 0) == rom[0]);
+
+	// Free - ROM and pages freed once neither memory references them
+	ngc_mem_empty(&dst);
+	TEST_ASSERT(!dst.rom && src.rom->refs == 1);
+	TEST_ASSERT(ngc_ram_get(&src, 0x2011) == word_other);
+	ngc_mem_empty(&src);
+	TEST_ASSERT(!src.rom && !src.ram[0] && ram_zero(&src));
+
+	return true;
+}
+
+int main(void)
+{
+	const struct test tests[] = {
+		{ "reset_scattered", test_reset_scattered },
+		{ "share_cow", test_share_cow }
+	};
+
+	size_t tests_len = sizeof(tests) / sizeof(tests[0]);
+	size_t passed_count = 0;
+	for (size_t tests_ind = 0; tests_ind < tests_len; tests_ind++) {
+		if (tests[tests_ind].f())
+			passed_count++;
+		else
+			printf("Failed: %s\n", tests[tests_ind].name);
+	}
+
+	printf("Passed: %zu/%zu\n", passed_count, tests_len);
+	return (passed_count == tests_len) ? 0 : 1;
+}
@@ -0,0 +1 @@
+DEFINE size 0x10
@@ -0,0 +1,179 @@
+#!/bin/sh
+
+# Exit with error message
+# $1 exit value
+# $2 error message
+_exit_err() {
+	printf "%s: %s\n" "$0" "$2" >&2
+	exit "$1"
+}
+
+# Set terminal foreground color
+# $1 color
+_term_color() {
+	tput setaf "$1" 2>/dev/null || printf "%b[3%sm" "\033" "$1"
+}
+
+# Validate executable file
+# $1 executable file path
+_exe_validate() {
+	[ -z "$1" ] && _exit_err 2 "Executable file not given"
+	! [ -f "$1" ] && _exit_err 2 "${1}: File not found"
+	! [ -x "$1" ] && _exit_err 2 "${1}: File not executable"
+}
+
+# Assemble each assembly file input of test into an object file, then link object files in order of assembly file names
+# Object files and linked machine code are output within the temp dir, so paths within errors are independent of the test
+# $1 test dir path
+# $2 linked machine code output path
+# Outputs stderr of failed assembly or linking
+_link() {
+	rm -f "${tmp_path}"/*.o "$2"
+	obj_names=
+	for in_file in $(find "$1" -type f -name "*${in_ext}" | sort); do
+		obj_name="$(basename "$in_file" | sed "s/${in_ext}\$/${obj_ext}/")"
+		"$asm_path" -c -o "${tmp_path}/${obj_name}" "$in_file" 2>&1 || return
+		obj_names="${obj_names} ${obj_name}"
+	done
+
+	# Object file names do not contain whitespace, so are split intentionally
+	# shellcheck disable=SC2086
+	(cd "$tmp_path" && "$ld_path" -o "$2" $obj_names 2>&1)
+}
+
+# Set config based on environment variables
+[ -z "$NO_COLOR" ] && term_color=1 || term_color=0
+[ "${LANG#*UTF-8}" != "$LANG" ] && term_unicode=1 || term_unicode=0
+
+# Convert long options to short options
+for arg in "$@"; do
+	shift
+	case "$arg" in
+		"--ascii")    set -- "$@" "-a" ;;
+		"--no-color") set -- "$@" "-p" ;;
+		*)            set -- "$@" "$arg" ;;
+	esac
+done
+OPTIND=1
+
+# Parse options
+while getopts ":ap" opt; do
+	case "$opt" in
+		a) term_unicode=0 ;;
+		p) term_color=0 ;;
+		\?) _exit_err 2 "-${OPTARG}: Option invalid" ;;
+		:) _exit_err 2 "-${OPTARG}: Option requires an argument" ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+# Get + validate executable files, as absolute paths since linking is run within the temp dir
+_exe_validate "$1"
+_exe_validate "$2"
+asm_path="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")" && readonly asm_path
+ld_path="$(cd "$(dirname "$2")" && pwd)/$(basename "$2")" && readonly ld_path
+
+# Get test files
+base_path="$(dirname "$0")" && readonly base_path
+pos_path="${base_path}/positive" && readonly pos_path
+neg_path="${base_path}/negative" && readonly neg_path
+in_ext='.in' && readonly in_ext
+obj_ext='.o' && readonly obj_ext
+out_ext='.out' && readonly out_ext
+err_ext='.err' && readonly err_ext
+
+# Create temp dir, removed on exit
+tmp_path="${TMPDIR:-/tmp}/ngc-ld-test.$$" && readonly tmp_path
+mkdir "$tmp_path" || _exit_err 3 "${tmp_path}: Failed to create dir"
+trap 'rm -rf "$tmp_path"' EXIT
+trap 'exit 1' HUP INT TERM
+bin_path="${tmp_path}/linked.bin" && readonly bin_path
+
+# Init test results
+total_count=0
+passed_count=0
+failed_count=0
+failed_names=
+
+# Execute positive tests
+pos_test_dirs="$(find "$pos_path" -mindepth 1 -maxdepth 1 -type d)"
+for test_dir in $pos_test_dirs; do
+	total_count=$((total_count + 1))
+
+	# Arrange - Find file storing expected machine code
+	out_file="${test_dir}${out_ext}"
+	! [ -f "$out_file" ] && _exit_err 3 "${out_file}: File not found"
+
+	# Act - Assemble and link, concat both stdout and stderr
+	exe_result="$(_link "$test_dir" "$bin_path")"
+
+	# Assert
+	# - Linking should output expected machine code
+	# - Assembling and linking should return no stdout or stderr - any output should cause assertion to fail
+	if [ -z "$exe_result" ] && cmp -s "$bin_path" "$out_file"; then
+		passed_count=$((passed_count + 1))
+	else
+		failed_count=$((failed_count + 1))
+		failed_names="${failed_names}${test_dir}\n"
+	fi
+done
+
+# Execute negative tests
+neg_test_dirs="$(find "$neg_path" -mindepth 1 -maxdepth 1 -type d)"
+for test_dir in $neg_test_dirs; do
+	total_count=$((total_count + 1))
+
+	# Arrange - Find file storing expected stderr
+	err_file="${test_dir}${err_ext}"
+	! [ -f "$err_file" ] && _exit_err 3 "${err_file}: File not found"
+
+	# Arrange - Build expected stderr
+	err_expected="$(cat "$err_file")"
+
+	# Act - Assemble and link, concat both stdout and stderr
+	exe_result="$(_link "$test_dir" "$bin_path")"
+
+	# Assert
+	# - Linking should return expected stderr
+	# - Linking should output no machine code
+	if [ "$exe_result" = "$err_expected" ] && ! [ -f "$bin_path" ]; then
+		passed_count=$((passed_count + 1))
+	else
+		failed_count=$((failed_count + 1))
+		failed_names="${failed_names}${test_dir}\n"
+	fi
+done
+
+# Init output
+passed_prefix=
+failed_prefix=
+suffix=
+
+if [ "$term_color" -eq 1 ]; then
+	if [ "$failed_count" -gt 0 ]; then
+		passed_prefix="${passed_prefix}$(_term_color 3)"
+		failed_prefix="${failed_prefix}$(_term_color 1)"
+	else
+		passed_prefix="${passed_prefix}$(_term_color 2)"
+	fi
+
+	suffix="$(tput sgr0 2>/dev/null || printf "%b[m" "\033")"
+fi
+
+if [ "$term_unicode" -eq 1 ]; then
+	passed_prefix="${passed_prefix}\0342\0234\0224 "
+	failed_prefix="${failed_prefix}\0342\0234\0230 "
+fi
+
+# Output test results
+echo "${passed_prefix}Passed: ${passed_count}/${total_count}${suffix}"
+
+if [ "$failed_count" -gt 0 ]; then
+	echo "${failed_prefix}Failed: ${failed_count}/${total_count}${suffix}"
+	printf "%b" "$failed_names" | while read -r failed_name; do
+		echo "${failed_name}"
+	done
+	exit 1
+else
+	exit 0
+fi